@@ -0,0 +1,136 @@
+/***
+    Copyright 2014 Carl Edwards
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing,
+    software distributed under the License is distributed on an
+    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+    KIND, either express or implied.  See the License for the
+    specific language governing permissions and limitations
+    under the License.
+*/
+
+#include "cues.h"
+#include "timing.h"
+#include "pebble.h"
+
+/*
+    Haptic cues.  The start and end cues are the firmware double pulse the
+    app has always used; the others are const segment arrays.  The cues
+    within a count are driven off the second tick the count already
+    subscribes to, so playing a cue never creates a timer or allocates.
+    Segments alternate on/off durations in ms, starting with on.
+*/
+
+#define DELAY_TICK_PULSE_MS 30
+#define HALFWAY_PULSE_MS 60
+#define FINAL_PULSE_MS 80
+
+static const uint32_t DELAY_TICK_SEGMENTS[] = { DELAY_TICK_PULSE_MS };
+static const uint32_t HALFWAY_SEGMENTS[] = { HALFWAY_PULSE_MS, 80, HALFWAY_PULSE_MS };
+static const uint32_t FINAL_SEGMENTS[] = { FINAL_PULSE_MS };
+
+typedef struct {
+    VibePattern pattern;    // no segments means the firmware double pulse
+    uint16_t motor_on_ms;   // sum of the "on" segments
+} CuePattern;
+
+static const CuePattern CUE_PATTERNS[CueCount] = {
+    [CueStart] = { { NULL, 0 }, CUES_DOUBLE_PULSE_MOTOR_ON_MS },
+    [CueEnd] = { { NULL, 0 }, CUES_DOUBLE_PULSE_MOTOR_ON_MS },
+    [CueDelayTick] = { { DELAY_TICK_SEGMENTS, ARRAY_LENGTH(DELAY_TICK_SEGMENTS) }, DELAY_TICK_PULSE_MS },
+    [CueHalfway] = { { HALFWAY_SEGMENTS, ARRAY_LENGTH(HALFWAY_SEGMENTS) }, 2 * HALFWAY_PULSE_MS },
+    [CueFinal] = { { FINAL_SEGMENTS, ARRAY_LENGTH(FINAL_SEGMENTS) }, FINAL_PULSE_MS },
+};
+
+const char * const CUE_NAMES[CueCount] = {
+    [CueStart] = "start",
+    [CueEnd] = "end",
+    [CueDelayTick] = "countdown",
+    [CueHalfway] = "halfway",
+    [CueFinal] = "3-2-1",
+};
+
+const char * const CUE_SCHEDULE_NAMES[VitalsCuesScheduleCount] = {
+    [VitalsCuesStartEnd] = "Start/End",
+    [VitalsCuesCountdown] = "Countdown",
+    [VitalsCuesFinal] = "Halfway, 3-2-1",
+    [VitalsCuesAll] = "All",
+};
+
+#define CUE_BIT(cue) (1 << (cue))
+
+// the cues each schedule plays in addition to start and end
+static const uint8_t CUE_SCHEDULES[VitalsCuesScheduleCount] = {
+    [VitalsCuesStartEnd] = 0,
+    [VitalsCuesCountdown] = CUE_BIT(CueDelayTick),
+    [VitalsCuesFinal] = CUE_BIT(CueHalfway) | CUE_BIT(CueFinal),
+    [VitalsCuesAll] = CUE_BIT(CueDelayTick) | CUE_BIT(CueHalfway) | CUE_BIT(CueFinal),
+};
+
+static uint16_t count_motor_on_ms;
+
+void cues_start_count() {
+    count_motor_on_ms = 0;
+}
+
+VitalsCueSchedule cues_schedule() {
+    // never index the schedule table with a value that did not come from it
+    if (app.settings.cues < 0 || app.settings.cues >= VitalsCuesScheduleCount) {
+        return VitalsCuesStartEnd;
+    }
+    return app.settings.cues;
+}
+
+void cues_play(Cue cue) {
+    if (app.settings.vibrate == false) {
+        return;
+    }
+    if (cue != CueStart && cue != CueEnd && (CUE_SCHEDULES[cues_schedule()] & CUE_BIT(cue)) == 0) {
+        return;
+    }
+    const CuePattern *cue_pattern = &CUE_PATTERNS[cue];
+    if (cue_pattern->pattern.num_segments == 0) {
+        vibes_double_pulse();
+    }
+    else {
+        vibes_enqueue_custom_pattern(cue_pattern->pattern);
+    }
+    count_motor_on_ms += cue_pattern->motor_on_ms;
+    timing_record_cue(cue, cue_pattern->motor_on_ms);
+
+    // the end cue closes the count, so its total is the cost of this schedule for one count
+    if (cue == CueEnd) {
+        timing_record_count_cues(cues_schedule(), count_motor_on_ms);
+    }
+}
+
+void cues_tick() {
+    // tick n of a count lands somewhere in (n-1, n] seconds after the start,
+    // so these cues always come at least a second before the start/end pulse
+    int elapsed_seconds = app_count_elapsed_seconds();
+
+    int delay = app.settings.delay;
+    if (elapsed_seconds < delay) {
+        cues_play(CueDelayTick);
+        return;
+    }
+
+    int count_seconds = elapsed_seconds - delay;
+    int remaining = app.settings.timeout - count_seconds;
+    if (count_seconds == app.settings.timeout / 2) {
+        cues_play(CueHalfway);
+    }
+    else if (remaining >= 1 && remaining <= 3) {
+        cues_play(CueFinal);
+    }
+}
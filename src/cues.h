@@ -0,0 +1,55 @@
+/***
+    Copyright 2014 Carl Edwards
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing,
+    software distributed under the License is distributed on an
+    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+    KIND, either express or implied.  See the License for the
+    specific language governing permissions and limitations
+    under the License.
+*/
+
+#pragma once
+
+#include "vitals.h"
+#include "pebble.h"
+
+// which cues a count plays, the Haptic Cues setting
+typedef enum {
+    VitalsCuesStartEnd = 0,
+    VitalsCuesCountdown,
+    VitalsCuesFinal,
+    VitalsCuesAll,
+    VitalsCuesScheduleCount
+} VitalsCueSchedule;
+
+typedef enum {
+    CueStart = 0,   // start delay is over, begin counting
+    CueEnd,         // count is over
+    CueDelayTick,   // each second of the start delay
+    CueHalfway,     // halfway through the count
+    CueFinal,       // each of the last 3 seconds of the count
+    CueCount
+} Cue;
+
+// display names, the schedule names are also the Haptic Cues menu subtitles
+extern const char * const CUE_NAMES[CueCount];
+extern const char * const CUE_SCHEDULE_NAMES[VitalsCuesScheduleCount];
+
+// the SDK does not publish the firmware double pulse's segments, so its
+// cost is an estimate: two pulses of 100ms each
+#define CUES_DOUBLE_PULSE_MOTOR_ON_MS 200
+
+void cues_start_count();
+void cues_tick();
+void cues_play(Cue cue);
@@ -0,0 +1,88 @@
+/***
+    Copyright 2014 Carl Edwards
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing,
+    software distributed under the License is distributed on an
+    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+    KIND, either express or implied.  See the License for the
+    specific language governing permissions and limitations
+    under the License.
+*/
+
+#pragma once
+
+#include "pebble.h"
+
+/*
+    Per-platform layout constants.  Each platform build sees only its own
+    values, so the date layout is a table lookup instead of frame arithmetic.
+    Every platform's table comes from the same rule, the DATE_* macros below,
+    applied to the display size and its margins; only the margins are tuned
+    per display.  The table itself is DATE_LAYOUTS in vitals.c.
+*/
+
+#if defined(PBL_PLATFORM_EMERY)
+
+// 200x228 rectangular, margins keep the date the same fraction of the dial from center as 144x168
+#define SCREEN_WIDTH        200
+#define SCREEN_HEIGHT       228
+#define TOP_BOTTOM_MARGIN    16
+#define LEFT_RIGHT_MARGIN    18
+#define MINUTE_HAND_LENGTH   88
+#define HOUR_HAND_LENGTH     60
+#define SECOND_HAND_LENGTH   96
+
+#elif defined(PBL_PLATFORM_GABBRO)
+
+// 260x260 round, margins keep the date the same fraction of the dial from center as 180x180
+#define SCREEN_WIDTH        260
+#define SCREEN_HEIGHT       260
+#define TOP_BOTTOM_MARGIN    35
+#define LEFT_RIGHT_MARGIN    26
+#define MINUTE_HAND_LENGTH   91
+#define HOUR_HAND_LENGTH     62
+#define SECOND_HAND_LENGTH  126
+
+#elif defined(PBL_ROUND)
+
+// 180x180 round
+#define SCREEN_WIDTH        180
+#define SCREEN_HEIGHT       180
+#define TOP_BOTTOM_MARGIN    12
+#define LEFT_RIGHT_MARGIN     5
+#define MINUTE_HAND_LENGTH   63
+#define HOUR_HAND_LENGTH     43
+#define SECOND_HAND_LENGTH   86
+
+#else
+
+// 144x168 rectangular
+#define SCREEN_WIDTH        144
+#define SCREEN_HEIGHT       168
+#define TOP_BOTTOM_MARGIN     1
+#define LEFT_RIGHT_MARGIN     0
+#define MINUTE_HAND_LENGTH   63
+#define HOUR_HAND_LENGTH     43
+#define SECOND_HAND_LENGTH   68
+
+#endif
+
+// day and num labels side by side (Top, Bottom) or stacked (Right, Left); all values fold to constants
+#define DATE_LABEL_W 40
+#define DATE_LABEL_H 30
+#define DATE_SIDE_BY_SIDE(y) \
+    { {{SCREEN_WIDTH/2 - 37, (y)}, {DATE_LABEL_W, DATE_LABEL_H}}, GTextAlignmentRight, \
+      {{SCREEN_WIDTH/2 + 9, (y)}, {DATE_LABEL_W, DATE_LABEL_H}}, GTextAlignmentLeft }
+#define DATE_STACKED(x) \
+    { {{(x), SCREEN_HEIGHT/2 - 28}, {DATE_LABEL_W, DATE_LABEL_H}}, GTextAlignmentCenter, \
+      {{(x), SCREEN_HEIGHT/2 - 7}, {DATE_LABEL_W, DATE_LABEL_H}}, GTextAlignmentCenter }
@@ -21,165 +21,125 @@
 
 #include "vitals.h"
 #include "settings.h"
+#include "timing.h"
+#include "cues.h"
 #include "pebble.h"
 
+// persist keys must never change or be reused, stored settings are looked up by them
 #define TIMEOUT_SETTINGS_KEY 1
 #define DELAY_SETTINGS_KEY 2
 #define VIBRATE_SETTINGS_KEY 3
 #define SECONDS_HAND_SETTINGS_KEY 4
-
-#define TIMEOUT_DEFAULT 30
-#define DELAY_DEFAULT 5
-#define VIBRATE_DEFAULT true
-#define SECONDS_HAND_DEFAULT true
+#define CUES_SETTINGS_KEY 5
 
 typedef enum {
     VitalsMenuTimeout = 0,
     VitalsMenuDelay,
     VitalsMenuVibrate,
     VitalsMenuSecondsHand,
+    VitalsMenuCues,
     VitalsMenuItemCount
 } VitalsMenuId; // Aliases for each menu item by index
 
+typedef struct {
+    const char *title;
+    uint32_t persist_key;
+    int *field;                         // the setting in app.settings
+    uint8_t default_index;
+    uint8_t num_values;
+    const int *values;                  // cycled through in order on each tap
+    const char * const *subtitles;      // one per value
+} SettingsOption;
+
+static const int TIMEOUT_VALUES[] = { 15, 30, 60 };
+static const char * const TIMEOUT_SUBTITLES[] = { "15 seconds", "30 seconds", "60 seconds" };
+
+static const int DELAY_VALUES[] = { 3, 5, 10 };
+static const char * const DELAY_SUBTITLES[] = { "3 seconds", "5 seconds", "10 seconds" };
+
+static const int ON_OFF_VALUES[] = { true, false };
+static const char * const ON_OFF_SUBTITLES[] = { "ON", "OFF" };
+
+// the subtitles are CUE_SCHEDULE_NAMES, indexed by these values
+static const int CUES_VALUES[] = { VitalsCuesStartEnd, VitalsCuesCountdown, VitalsCuesFinal, VitalsCuesAll };
+
+#define SETTINGS_OPTION(title, key, field, default_index, values, subtitles) \
+    { title, key, &app.settings.field, default_index, ARRAY_LENGTH(values), values, subtitles }
+
+// defaults are an index into the values
+static const SettingsOption SETTINGS_OPTIONS[VitalsMenuItemCount] = {
+    [VitalsMenuTimeout] = SETTINGS_OPTION("HB Count Time", TIMEOUT_SETTINGS_KEY, timeout, 1, TIMEOUT_VALUES, TIMEOUT_SUBTITLES),
+    [VitalsMenuDelay] = SETTINGS_OPTION("Start Delay", DELAY_SETTINGS_KEY, delay, 1, DELAY_VALUES, DELAY_SUBTITLES),
+    [VitalsMenuVibrate] = SETTINGS_OPTION("Vibration", VIBRATE_SETTINGS_KEY, vibrate, 0, ON_OFF_VALUES, ON_OFF_SUBTITLES),
+    [VitalsMenuSecondsHand] = SETTINGS_OPTION("Seconds Hand", SECONDS_HAND_SETTINGS_KEY, seconds_hand, 0, ON_OFF_VALUES, ON_OFF_SUBTITLES),
+    [VitalsMenuCues] = SETTINGS_OPTION("Haptic Cues", CUES_SETTINGS_KEY, cues, 0, CUES_VALUES, CUE_SCHEDULE_NAMES),
+};
+
 static SimpleMenuLayer *settings_menu_layer;
 static SimpleMenuItem settings_menu_items[VitalsMenuItemCount];
 static SimpleMenuSection settings_menu_section_root;
 static SimpleMenuSection settings_menu_section_all[1];
+static ClickConfigProvider menu_click_config_provider;
 
-void vitals_update_menus() {
-    SimpleMenuItem *m;
-    static char beatTimeString[30];
-    static char startDelayString[30];
-    static char vibrationString[30];
-    static char secondsHandString[30];
-    for (VitalsMenuId id = 0; id < VitalsMenuItemCount; id++) {
-        m = &settings_menu_items[id];
-        switch (id) {
-            case VitalsMenuTimeout:
-                m->title = "HB Count Time";
-                snprintf(beatTimeString, ARRAY_LENGTH(beatTimeString), "%d seconds", app.settings.timeout);
-                m->subtitle = beatTimeString;
-                break;
-                
-            case VitalsMenuDelay:
-                m->title = "Start Delay";
-                snprintf(startDelayString, ARRAY_LENGTH(startDelayString), "%d seconds", app.settings.delay);
-                m->subtitle = startDelayString;
-                break;
-                
-            case VitalsMenuVibrate:
-                m->title = "Vibration";
-                snprintf(vibrationString, ARRAY_LENGTH(vibrationString), "%s", app.settings.vibrate ? "ON" : "OFF");
-                m->subtitle = vibrationString;
-                break;
-                
-            case VitalsMenuSecondsHand:
-                m->title = "Seconds Hand";
-                snprintf(secondsHandString, ARRAY_LENGTH(secondsHandString), "%s", app.settings.seconds_hand ? "ON" : "OFF");
-                m->subtitle = secondsHandString;
-                break;
-                
-            default:
-                break;
-        }
-    }
-    menu_layer_reload_data((MenuLayer *)settings_menu_layer);
-}
-
-void set_timeout(int timeout) {
-    app.settings.timeout = timeout;
-    persist_write_int(TIMEOUT_SETTINGS_KEY, timeout);
-}
+static uint8_t settings_value_index[VitalsMenuItemCount];
 
-void set_delay(int delay) {
-    app.settings.delay = delay;
-    persist_write_int(DELAY_SETTINGS_KEY, delay);
-}
+void set_option_index(VitalsMenuId id, uint8_t index) {
+    const SettingsOption *option = &SETTINGS_OPTIONS[id];
+    int value = option->values[index];
 
-void set_vibrate(bool vibrate) {
-    app.settings.vibrate = vibrate;
-    persist_write_int(VIBRATE_SETTINGS_KEY, vibrate);
+    settings_value_index[id] = index;
+    *option->field = value;
+    settings_menu_items[id].subtitle = option->subtitles[index];
 }
 
-void set_seconds_hand(bool enabled) {
-    app.settings.seconds_hand = enabled;
-    persist_write_int(SECONDS_HAND_SETTINGS_KEY, enabled);
+void save_option(VitalsMenuId id) {
+    const SettingsOption *option = &SETTINGS_OPTIONS[id];
+    persist_write_int(option->persist_key, option->values[settings_value_index[id]]);
 }
 
 void settings_menu_select(int index, void *context) {
-    VitalsSettings *s = &app.settings;
     VitalsMenuId id = index;
-    switch (id) {
-        case VitalsMenuTimeout:
-            if (s->timeout == 15) {
-                set_timeout(30);
-            }
-            else if (s->timeout == 30) {
-                set_timeout(60);
-            }
-            else {
-                set_timeout(15);
-            }
-            break;
-        
-        case VitalsMenuDelay:
-            if (s->delay == 3) {
-                set_delay(5);
-            }
-            else if (s->delay == 5) {
-                set_delay(10);
-            }
-            else {
-                set_delay(3);
-            }
-            break;
-
-        case VitalsMenuVibrate:
-            set_vibrate(!s->vibrate);
-            break;
-
-        case VitalsMenuSecondsHand:
-            set_seconds_hand(!s->seconds_hand);
-            break;
-            
-        default:
-            return;
+    if (id >= VitalsMenuItemCount) {
+        return;
     }
-    vitals_update_menus();
+    set_option_index(id, (settings_value_index[id] + 1) % SETTINGS_OPTIONS[id].num_values);
+    save_option(id);
+
+    // only the subtitle pointer changed, the row count and heights are the same
+    layer_mark_dirty(simple_menu_layer_get_layer(settings_menu_layer));
 }
 
 void load_settings_from_storage() {
-    if (persist_exists(TIMEOUT_SETTINGS_KEY) == false) {
-        set_timeout(TIMEOUT_DEFAULT);
-    }
-    else {
-        app.settings.timeout = persist_read_int(TIMEOUT_SETTINGS_KEY);
-    }
-    
-    if (persist_exists(DELAY_SETTINGS_KEY) == false) {
-        set_delay(DELAY_DEFAULT);
-    }
-    else {
-        app.settings.delay = persist_read_int(DELAY_SETTINGS_KEY);
-    }
-    
-    if (persist_exists(VIBRATE_SETTINGS_KEY) == false) {
-        set_vibrate(VIBRATE_DEFAULT);
-    }
-    else {
-        app.settings.vibrate = persist_read_bool(VIBRATE_SETTINGS_KEY);
-    }
+    for (VitalsMenuId id = 0; id < VitalsMenuItemCount; id++) {
+        const SettingsOption *option = &SETTINGS_OPTIONS[id];
+        bool found = false;
+
+        if (persist_exists(option->persist_key)) {
+            int stored = persist_read_int(option->persist_key);
+            for (uint8_t i = 0; i < option->num_values && !found; i++) {
+                if (option->values[i] == stored) {
+                    set_option_index(id, i);
+                    found = true;
+                }
+            }
+        }
 
-    if (persist_exists(SECONDS_HAND_SETTINGS_KEY) == false) {
-        set_seconds_hand(SECONDS_HAND_DEFAULT);
-    }
-    else {
-        app.settings.seconds_hand = persist_read_bool(SECONDS_HAND_SETTINGS_KEY);
+        // missing or no longer an allowed value
+        if (!found) {
+            set_option_index(id, option->default_index);
+            save_option(id);
+        }
     }
 }
 
-void settings_window_load(Window *window) {
-    vitals_update_menus();
+void diagnostics_long_click_handler(ClickRecognizerRef recognizer, void *context) {
+    timing_window_show();
+}
+
+void settings_click_config_provider(void *context) {
+    // keep the menu's own button handling and add the hidden long-press
+    menu_click_config_provider(context);
+    window_long_click_subscribe(BUTTON_ID_SELECT, 0, (ClickHandler)diagnostics_long_click_handler, (ClickHandler)NULL);
 }
 
 void settings_window_unload(Window *window) {
@@ -187,6 +147,10 @@ void settings_window_unload(Window *window) {
 }
 
 void settings_init() {
+    for (VitalsMenuId id = 0; id < VitalsMenuItemCount; id++) {
+        settings_menu_items[id].title = SETTINGS_OPTIONS[id].title;
+        settings_menu_items[id].callback = settings_menu_select;
+    }
     load_settings_from_storage();
     
     app.settings_window = window_create();
@@ -197,13 +161,9 @@ void settings_init() {
 
     window_set_background_color(app.settings_window, GColorWhite);
     window_set_window_handlers(app.settings_window, (WindowHandlers){
-        .load = settings_window_load,
         .unload = settings_window_unload,
     });
     
-    for (VitalsMenuId id = 0; id < VitalsMenuItemCount; id++) {
-        settings_menu_items[id].callback = settings_menu_select;
-    }
     settings_menu_section_root.items = settings_menu_items;
     settings_menu_section_root.num_items = VitalsMenuItemCount;
 #if PBL_ROUND
@@ -218,7 +178,12 @@ void settings_init() {
         layer_get_frame(window_get_root_layer(app.settings_window)),
         app.settings_window,
         settings_menu_section_all,
-        1,
+        ARRAY_LENGTH(settings_menu_section_all),
         NULL);
     layer_add_child(window_get_root_layer(app.settings_window), simple_menu_layer_get_layer(settings_menu_layer));
+
+    // a long-press of the Middle Button in the settings opens the hidden timer latency page
+    menu_click_config_provider = window_get_click_config_provider(app.settings_window);
+    window_set_click_config_provider_with_context(app.settings_window,
+        settings_click_config_provider, window_get_click_config_context(app.settings_window));
 }
@@ -0,0 +1,218 @@
+/***
+    Copyright 2014 Carl Edwards
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing,
+    software distributed under the License is distributed on an
+    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+    KIND, either express or implied.  See the License for the
+    specific language governing permissions and limitations
+    under the License.
+*/
+
+#include "timing.h"
+#include "pebble.h"
+
+/*
+    Always-on timer latency instrumentation.  Each series keeps a fixed
+    bucket histogram in static memory; recording a sample is a time_ms
+    call and a short bucket scan.
+*/
+
+// upper bound (exclusive) of each bucket in ms, the last bucket catches the rest
+static const uint16_t BUCKET_LIMITS[TIMING_BUCKET_COUNT - 1] = { 10, 25, 50, 100, 250 };
+static const char *BUCKET_LABELS[TIMING_BUCKET_COUNT] = { "<10", "<25", "<50", "<100", "<250", "250+" };
+static const char *SERIES_NAMES[TimingSeriesCount] = { "Delay", "Timeout", "Tick", "Hand" };
+
+static TimingHistogram histograms[TimingSeriesCount];
+static int64_t count_start_ms;
+
+// haptic cost per cue, and per completed count for each schedule, so schedules can be compared
+static uint16_t cue_plays[CueCount];
+static uint32_t cue_motor_on_ms[CueCount];
+static TimingScheduleCost schedule_costs[VitalsCuesScheduleCount];
+
+static Window *timing_window;
+static TextLayer *timing_text_layer;
+static char timing_text[320];
+
+int64_t timing_now_ms() {
+    time_t seconds;
+    uint16_t ms;
+    time_ms(&seconds, &ms);
+    return (int64_t)seconds * 1000 + ms;
+}
+
+void timing_record_latency(TimingSeries series, int64_t latency_ms) {
+    TimingHistogram *h = &histograms[series];
+    int16_t latency = latency_ms < INT16_MIN ? INT16_MIN : latency_ms > INT16_MAX ? INT16_MAX : (int16_t)latency_ms;
+    int size = latency < 0 ? -latency : latency;
+
+    int bucket = 0;
+    while (bucket < TIMING_BUCKET_COUNT - 1 && size >= BUCKET_LIMITS[bucket]) {
+        bucket++;
+    }
+    if (h->buckets[bucket] < UINT16_MAX) {
+        h->buckets[bucket]++;
+    }
+    if (h->samples == 0 || latency < h->min_ms) {
+        h->min_ms = latency;
+    }
+    if (h->samples == 0 || latency > h->max_ms) {
+        h->max_ms = latency;
+    }
+    if (h->samples < UINT16_MAX) {
+        h->samples++;
+    }
+}
+
+void timing_schedule(TimingSeries series, uint32_t delay_ms) {
+    histograms[series].due_ms = timing_now_ms() + delay_ms;
+}
+
+void timing_fire(TimingSeries series) {
+    timing_record_latency(series, timing_now_ms() - histograms[series].due_ms);
+}
+
+void timing_start_count() {
+    count_start_ms = timing_now_ms();
+}
+
+void timing_record_tick(int hand_seconds) {
+    // second ticks are due on the second boundary, so the ms part of the
+    // current time is how late this one was delivered
+    uint16_t ms;
+    time_ms(NULL, &ms);
+    timing_record_latency(TimingSeriesTickLag, ms);
+
+    // the hand steps on wall-clock seconds but a count starts at any ms,
+    // so the hand runs ahead of the real count by up to a second
+    timing_record_latency(TimingSeriesHandDrift, hand_seconds * 1000 - (timing_now_ms() - count_start_ms));
+}
+
+void timing_record_cue(Cue cue, uint16_t motor_on_ms) {
+    if (cue_plays[cue] < UINT16_MAX) {
+        cue_plays[cue]++;
+    }
+    cue_motor_on_ms[cue] += motor_on_ms;
+}
+
+void timing_record_count_cues(VitalsCueSchedule schedule, uint16_t motor_on_ms) {
+    TimingScheduleCost *cost = &schedule_costs[schedule];
+    if (cost->counts < UINT16_MAX) {
+        cost->counts++;
+    }
+    cost->motor_on_ms += motor_on_ms;
+}
+
+int timing_schedule_average_ms(VitalsCueSchedule schedule) {
+    const TimingScheduleCost *cost = &schedule_costs[schedule];
+    return cost->counts ? (int)(cost->motor_on_ms / cost->counts) : 0;
+}
+
+void timing_format(char *buffer, size_t size) {
+    size_t len = 0;
+    len += snprintf(buffer + len, size - len, "ms:");
+    for (int b = 0; b < TIMING_BUCKET_COUNT && len < size; b++) {
+        len += snprintf(buffer + len, size - len, " %s", BUCKET_LABELS[b]);
+    }
+    for (TimingSeries s = 0; s < TimingSeriesCount && len < size; s++) {
+        TimingHistogram *h = &histograms[s];
+        len += snprintf(buffer + len, size - len, "\n%s n=%d %d..%d\n ", SERIES_NAMES[s], h->samples, h->min_ms, h->max_ms);
+        for (int b = 0; b < TIMING_BUCKET_COUNT && len < size; b++) {
+            len += snprintf(buffer + len, size - len, " %d", h->buckets[b]);
+        }
+    }
+    // plays per cue, then the average motor-on ms per count for each schedule
+    if (len < size) {
+        len += snprintf(buffer + len, size - len, "\nCues");
+    }
+    for (Cue c = 0; c < CueCount && len < size; c++) {
+        len += snprintf(buffer + len, size - len, " %d", cue_plays[c]);
+    }
+    if (len < size) {
+        len += snprintf(buffer + len, size - len, "\nms/count");
+    }
+    for (VitalsCueSchedule sc = 0; sc < VitalsCuesScheduleCount && len < size; sc++) {
+        len += snprintf(buffer + len, size - len, " %d", timing_schedule_average_ms(sc));
+    }
+}
+
+void timing_log() {
+    for (TimingSeries s = 0; s < TimingSeriesCount; s++) {
+        TimingHistogram *h = &histograms[s];
+        APP_LOG(APP_LOG_LEVEL_INFO, "timing %s n=%d min=%dms max=%dms buckets=%d/%d/%d/%d/%d/%d",
+            SERIES_NAMES[s], h->samples, h->min_ms, h->max_ms,
+            h->buckets[0], h->buckets[1], h->buckets[2], h->buckets[3], h->buckets[4], h->buckets[5]);
+    }
+    for (Cue c = 0; c < CueCount; c++) {
+        APP_LOG(APP_LOG_LEVEL_INFO, "timing cue %s n=%d motor=%dms",
+            CUE_NAMES[c], cue_plays[c], (int)cue_motor_on_ms[c]);
+    }
+    for (VitalsCueSchedule sc = 0; sc < VitalsCuesScheduleCount; sc++) {
+        APP_LOG(APP_LOG_LEVEL_INFO, "timing schedule %s counts=%d motor=%dms avg=%dms/count",
+            CUE_SCHEDULE_NAMES[sc], schedule_costs[sc].counts, (int)schedule_costs[sc].motor_on_ms, timing_schedule_average_ms(sc));
+    }
+}
+
+const TimingHistogram *timing_histogram(TimingSeries series) {
+    return &histograms[series];
+}
+
+const TimingScheduleCost *timing_schedule_cost(VitalsCueSchedule schedule) {
+    return &schedule_costs[schedule];
+}
+
+void timing_window_load(Window *window) {
+    Layer *window_layer = window_get_root_layer(window);
+    GRect bounds = layer_get_bounds(window_layer);
+#if PBL_ROUND
+    bounds = GRect(bounds.origin.x + 18, bounds.origin.y + 24, bounds.size.w - 36, bounds.size.h - 24);
+#endif
+
+    timing_text_layer = text_layer_create(bounds);
+    text_layer_set_font(timing_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
+    layer_add_child(window_layer, text_layer_get_layer(timing_text_layer));
+}
+
+void timing_window_appear(Window *window) {
+    // the text is only formatted while the page is being shown
+    timing_format(timing_text, sizeof(timing_text));
+    text_layer_set_text(timing_text_layer, timing_text);
+}
+
+void timing_window_unload(Window *window) {
+    text_layer_destroy(timing_text_layer);
+}
+
+void timing_window_show() {
+    window_stack_push(timing_window, true);
+}
+
+void timing_init() {
+    timing_window = window_create();
+
+#ifdef PBL_SDK_2
+    window_set_fullscreen(timing_window, true);
+#endif
+
+    window_set_background_color(timing_window, GColorWhite);
+    window_set_window_handlers(timing_window, (WindowHandlers){
+        .load = timing_window_load,
+        .appear = timing_window_appear,
+        .unload = timing_window_unload,
+    });
+}
+
+void timing_deinit() {
+    window_destroy(timing_window);
+}
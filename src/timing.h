@@ -0,0 +1,63 @@
+/***
+    Copyright 2014 Carl Edwards
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing,
+    software distributed under the License is distributed on an
+    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+    KIND, either express or implied.  See the License for the
+    specific language governing permissions and limitations
+    under the License.
+*/
+
+#pragma once
+
+#include "cues.h"
+#include "pebble.h"
+
+typedef enum {
+    TimingSeriesDelayTimer = 0,   // delay_timer_callback lateness
+    TimingSeriesTimeoutTimer,     // timeout_timer_callback lateness
+    TimingSeriesTickLag,          // second tick delivery lag during a count
+    TimingSeriesHandDrift,        // second hand position minus real time since the count started
+    TimingSeriesCount
+} TimingSeries;
+
+#define TIMING_BUCKET_COUNT 6
+
+// samples are signed (negative is early), the buckets count them by size
+typedef struct {
+    int64_t due_ms;
+    uint16_t buckets[TIMING_BUCKET_COUNT];
+    uint16_t samples;
+    int16_t min_ms;
+    int16_t max_ms;
+} TimingHistogram;
+
+// haptic cost of one cue schedule over every count that completed with it
+typedef struct {
+    uint16_t counts;
+    uint32_t motor_on_ms;
+} TimingScheduleCost;
+
+void timing_init();
+void timing_deinit();
+void timing_schedule(TimingSeries series, uint32_t delay_ms);
+void timing_fire(TimingSeries series);
+void timing_start_count();
+void timing_record_tick(int hand_seconds);
+void timing_record_cue(Cue cue, uint16_t motor_on_ms);
+void timing_record_count_cues(VitalsCueSchedule schedule, uint16_t motor_on_ms);
+void timing_log();
+const TimingHistogram *timing_histogram(TimingSeries series);
+const TimingScheduleCost *timing_schedule_cost(VitalsCueSchedule schedule);
+void timing_window_show();
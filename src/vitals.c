@@ -21,6 +21,9 @@
 
 #include "vitals.h"
 #include "settings.h"
+#include "layout.h"
+#include "timing.h"
+#include "cues.h"
 #include "pebble.h"
 #include "string.h"
 #include "stdlib.h"
@@ -31,8 +34,8 @@ const GPathInfo MINUTE_HAND_POINTS =
   (GPoint []) {
     { -3, 12 },
     { 4, 12 },
-    { 4, -63 },
-    { -3, -63 }
+    { 4, -MINUTE_HAND_LENGTH },
+    { -3, -MINUTE_HAND_LENGTH }
   }
 };
 
@@ -40,24 +43,27 @@ const GPathInfo HOUR_HAND_POINTS = {
   4, (GPoint []){
     {-4, 12},
     {4, 12},
-    {4, -43},
-    {-4, -43}
+    {4, -HOUR_HAND_LENGTH},
+    {-4, -HOUR_HAND_LENGTH}
   }
 };
 
-VitalsApplication app;
+typedef struct {
+    GRect day_frame;
+    GTextAlignment day_alignment;
+    GRect num_frame;
+    GTextAlignment num_alignment;
+} DateLayout;
+
+// indexed by DateLocation (Top, Right, Bottom, Left)
+static const DateLayout DATE_LAYOUTS[] = {
+    DATE_SIDE_BY_SIDE(25 + TOP_BOTTOM_MARGIN),                  // Top
+    DATE_STACKED(SCREEN_WIDTH - 62 - LEFT_RIGHT_MARGIN),        // Right
+    DATE_SIDE_BY_SIDE(SCREEN_HEIGHT - 59 - TOP_BOTTOM_MARGIN),  // Bottom
+    DATE_STACKED(25 + LEFT_RIGHT_MARGIN),                       // Left
+};
 
-#if defined(PBL_RECT)
-#define SCREEN_WIDTH        144
-#define SCREEN_HEIGHT       168
-#define TOP_BOTTOM_MARGIN     1
-#define LEFT_RIGHT_MARGIN     0
-#elif defined(PBL_ROUND)
-#define SCREEN_WIDTH        180
-#define SCREEN_HEIGHT       180
-#define TOP_BOTTOM_MARGIN    12
-#define LEFT_RIGHT_MARGIN     5
-#endif
+VitalsApplication app;
 
 DateLocation get_obstructed_location_from_minutes(int minutes) {
     // this is tuned for the size of the date layer (dow + day)
@@ -135,31 +141,42 @@ void layout_date_layer(struct tm *t) {
     }
     app.date_location = location;
 
-    switch(app.date_location) {
-    case Right:
-        layer_set_frame((Layer *)app.day_label, GRect(SCREEN_WIDTH-62-LEFT_RIGHT_MARGIN, SCREEN_HEIGHT/2-28, 40, 30));
-        text_layer_set_text_alignment(app.day_label, GTextAlignmentCenter);
-        layer_set_frame((Layer *)app.num_label, GRect(SCREEN_WIDTH-62-LEFT_RIGHT_MARGIN, SCREEN_HEIGHT/2-7, 40, 30));
-        text_layer_set_text_alignment(app.num_label, GTextAlignmentCenter);
-        break;
-    case Bottom:
-        layer_set_frame((Layer *)app.day_label, GRect(SCREEN_WIDTH/2 - 37, SCREEN_HEIGHT-59-TOP_BOTTOM_MARGIN, 40, 30));
-        text_layer_set_text_alignment(app.day_label, GTextAlignmentRight);
-        layer_set_frame((Layer *)app.num_label, GRect(SCREEN_WIDTH/2 + 9, SCREEN_HEIGHT-59-TOP_BOTTOM_MARGIN, 40, 30));
-        text_layer_set_text_alignment(app.num_label, GTextAlignmentLeft);
-        break;
-    case Left:
-        layer_set_frame((Layer *)app.day_label, GRect(25+LEFT_RIGHT_MARGIN, SCREEN_HEIGHT/2-28, 40, 30));
-        text_layer_set_text_alignment(app.day_label, GTextAlignmentCenter);
-        layer_set_frame((Layer *)app.num_label, GRect(25+LEFT_RIGHT_MARGIN, SCREEN_HEIGHT/2-7, 40, 30));
-        text_layer_set_text_alignment(app.num_label, GTextAlignmentCenter);
-        break;
-    default:
-        layer_set_frame((Layer *)app.day_label, GRect(SCREEN_WIDTH/2 - 37, 25+TOP_BOTTOM_MARGIN, 40, 30));
-        text_layer_set_text_alignment(app.day_label, GTextAlignmentRight);
-        layer_set_frame((Layer *)app.num_label, GRect(SCREEN_WIDTH/2 + 9, 25+TOP_BOTTOM_MARGIN, 40, 30));
-        text_layer_set_text_alignment(app.num_label, GTextAlignmentLeft);
-    }
+    const DateLayout *layout = &DATE_LAYOUTS[location];
+    layer_set_frame(text_layer_get_layer(app.day_label), layout->day_frame);
+    text_layer_set_text_alignment(app.day_label, layout->day_alignment);
+    layer_set_frame(text_layer_get_layer(app.num_label), layout->num_frame);
+    text_layer_set_text_alignment(app.num_label, layout->num_alignment);
+}
+
+void draw_second_hand(GContext *ctx, GPoint center, int seconds) {
+    int32_t second_angle = TRIG_MAX_ANGLE * seconds / 60;
+    GPoint secondHand;
+
+    secondHand.y = (int16_t)(-cos_lookup(second_angle) * (int32_t)SECOND_HAND_LENGTH / TRIG_MAX_RATIO) + center.y;
+    secondHand.x = (int16_t)(sin_lookup(second_angle) * (int32_t)SECOND_HAND_LENGTH / TRIG_MAX_RATIO) + center.x;
+    graphics_context_set_stroke_color(ctx, GColorWhite);
+    graphics_draw_line(ctx, secondHand, center);
+}
+
+void draw_watch_hands(GContext *ctx, GPoint center, const struct tm *t) {
+    graphics_context_set_fill_color(ctx, GColorWhite);
+    graphics_context_set_stroke_color(ctx, GColorBlack);
+
+    // hour hand
+    gpath_rotate_to(app.hour_arrow, (TRIG_MAX_ANGLE * (((t->tm_hour % 12) * 6) + (t->tm_min / 10))) / (12 * 6));
+    gpath_draw_filled(ctx, app.hour_arrow);
+    gpath_draw_outline(ctx, app.hour_arrow);
+
+    // minute hand
+    gpath_rotate_to(app.minute_arrow, TRIG_MAX_ANGLE * t->tm_min / 60);
+    gpath_draw_filled(ctx, app.minute_arrow);
+    gpath_draw_outline(ctx, app.minute_arrow);
+
+    // draw the dot in the middle
+    graphics_context_set_fill_color(ctx, GColorWhite);
+    graphics_fill_circle(ctx, center, 4);
+    graphics_context_set_stroke_color(ctx, GColorBlack);
+    graphics_draw_circle(ctx, center, 4);
 }
 
 void hands_update_proc(Layer *layer, GContext *ctx) {
@@ -167,62 +184,57 @@ void hands_update_proc(Layer *layer, GContext *ctx) {
         return;
     }
 
+    // everything drawn comes from app state (render_time is captured on each tick),
+    // so the same state always renders the same frame
     GRect bounds = layer_get_bounds(layer);
     const GPoint center = grect_center_point(&bounds);
-    const int16_t secondHandLength = (bounds.size.w / 2) - 2;
+    const struct tm *t = &app.render_time;
 
-    GPoint secondHand;
+    if (app.settings.seconds_hand || app.state == VitalsStateCountPulses) {
+        draw_second_hand(ctx, center, app.state == VitalsStateCountPulses ? app.timer_seconds : t->tm_sec);
+    }
 
-    time_t now = time(NULL);
-    struct tm *t = localtime(&now);
+    if (app.state == VitalsStateWatch) {
+        draw_watch_hands(ctx, center, t);
+    }
+}
 
-    int32_t second_angle = TRIG_MAX_ANGLE * (app.state == VitalsStateCountPulses ? app.timer_seconds++ : t->tm_sec) / 60;
+void update_date_layer(struct tm *t, TimeUnits units_changed) {
+    // day changed: re-format the text (this also dirties the text layers)
+    if (units_changed & DAY_UNIT) {
+        strftime(app.day_buffer, sizeof(app.day_buffer), "%a", t);
+        text_layer_set_text(app.day_label, app.day_buffer);
 
-    // second hand
-    if (app.settings.seconds_hand || app.state == VitalsStateCountPulses) {
-        secondHand.y = (int16_t)(-cos_lookup(second_angle) * (int32_t)(secondHandLength-2) / TRIG_MAX_RATIO) + center.y;
-        secondHand.x = (int16_t)(sin_lookup(second_angle) * (int32_t)(secondHandLength-2) / TRIG_MAX_RATIO) + center.x;
-        graphics_context_set_stroke_color(ctx, GColorWhite);
-        graphics_draw_line(ctx, secondHand, center);
+        strftime(app.num_buffer, sizeof(app.num_buffer), "%d", t);
+        text_layer_set_text(app.num_label, app.num_buffer);
     }
 
-    if (app.state == VitalsStateWatch) {
-        graphics_context_set_fill_color(ctx, GColorWhite);
-        graphics_context_set_stroke_color(ctx, GColorBlack);
-
-        // hour hand
-        gpath_rotate_to(app.hour_arrow, (TRIG_MAX_ANGLE * (((t->tm_hour % 12) * 6) + (t->tm_min / 10))) / (12 * 6));
-        gpath_draw_filled(ctx, app.hour_arrow);
-        gpath_draw_outline(ctx, app.hour_arrow);
-
-        // minute hand
-        gpath_rotate_to(app.minute_arrow, TRIG_MAX_ANGLE * t->tm_min / 60);
-        gpath_draw_filled(ctx, app.minute_arrow);
-        gpath_draw_outline(ctx, app.minute_arrow);
-
-        // update the text in the date layer
-        if (t->tm_yday != app.last_tm_yday) {
-            strftime(app.day_buffer, sizeof(app.day_buffer), "%a", t);
-            text_layer_set_text(app.day_label, app.day_buffer);
-
-            strftime(app.num_buffer, sizeof(app.num_buffer), "%d", t);
-            text_layer_set_text(app.num_label, app.num_buffer);
-            app.last_tm_yday = t->tm_yday;
-        }
-        if (t->tm_hour != app.last_tm_hour || t->tm_min != app.last_tm_min) {
-            layout_date_layer(t);
-            app.last_tm_hour = t->tm_hour;
-            app.last_tm_min = t->tm_min;
-        }
-        // draw the dot in the middle
-        graphics_context_set_fill_color(ctx, GColorWhite);
-        graphics_fill_circle(ctx, center, 4);
-        graphics_context_set_stroke_color(ctx, GColorBlack);
-        graphics_draw_circle(ctx, center, 4);
+    // minute changed: the hands moved, so the date may need to move out of the way
+    if (units_changed & MINUTE_UNIT) {
+        layout_date_layer(t);
     }
 }
 
+int app_count_start_seconds() {
+    // the second hand starts the delay short of 12 so it reaches 12 as the count begins
+    return 60-app.settings.delay < 60 ? 60-app.settings.delay : 0;
+}
+
+int app_count_elapsed_seconds() {
+    return app.timer_seconds - app_count_start_seconds();
+}
+
 void handle_timer_tick(struct tm *tick_time, TimeUnits units_changed) {
+    app.render_time = *tick_time;
+
+    // the date layer is kept current while hidden so it is correct when the watch mode returns
+    update_date_layer(tick_time, units_changed);
+
+    if (app.state == VitalsStateCountPulses && (units_changed & SECOND_UNIT)) {
+        app.timer_seconds++;
+        timing_record_tick(app_count_elapsed_seconds());
+        cues_tick();
+    }
     layer_mark_dirty(app.hands_layer);
 }
 
@@ -234,20 +246,20 @@ void subscribe_tick_timer() {
 }
 
 void timeout_timer_callback(void *data) {
+    timing_fire(TimingSeriesTimeoutTimer);
     app.timeout_timer = (AppTimer *)NULL;
-    if (app.settings.vibrate) {
-        vibes_double_pulse();
-    }
+    cues_play(CueEnd);
     light_enable(false);
     app_set_state(VitalsStateWatch);
+    timing_log();
 }
 
 void delay_timer_callback(void *data) {
+    timing_fire(TimingSeriesDelayTimer);
     app.delay_timer = (AppTimer *)NULL;
-    if (app.settings.vibrate) {
-        vibes_double_pulse();
-    }
+    cues_play(CueStart);
     light_enable(true);
+    timing_schedule(TimingSeriesTimeoutTimer, app.settings.timeout * 1000);
     app.timeout_timer = app_timer_register(
         app.settings.timeout * 1000, timeout_timer_callback, (void *)0);
 }
@@ -302,9 +314,12 @@ void app_set_state(VitalsState new_state) {
     case VitalsStateCountPulses:
         layer_set_hidden(bitmap_layer_get_layer(app.heart_image_layer), false);
         layer_set_hidden(app.date_layer, true);
+        cues_start_count();
+        timing_start_count();
+        timing_schedule(TimingSeriesDelayTimer, app.settings.delay * 1000);
         app.delay_timer = app_timer_register(
             app.settings.delay * 1000, delay_timer_callback, (void *)0);
-        app.timer_seconds = 60-app.settings.delay < 60 ? 60-app.settings.delay : 0;
+        app.timer_seconds = app_count_start_seconds();
         break;
     case VitalsStateSettings:
         if (window_stack_contains_window(app.settings_window)) {
@@ -371,6 +386,11 @@ void window_load(Window *window) {
     text_layer_set_font(app.num_label, bold18);
     layer_add_child(app.date_layer, text_layer_get_layer(app.num_label));
 
+    // populate the date text and position for the current time
+    time_t now = time(NULL);
+    app.render_time = *localtime(&now);
+    update_date_layer(&app.render_time, DAY_UNIT | MINUTE_UNIT);
+
     // init hands
     app.hands_layer = layer_create(bounds);
     layer_set_update_proc(app.hands_layer, hands_update_proc);
@@ -390,13 +410,11 @@ void window_unload(Window *window) {
 
 void app_init(void) {
     settings_init();
+    timing_init();
     
     app.delay_timer = (AppTimer *)0;
     app.timeout_timer = (AppTimer *)0;
     app.date_location = -1;
-    app.last_tm_yday = -1;
-    app.last_tm_hour = -1;
-    app.last_tm_min = -1;
     app_set_state(VitalsStateWatch);
 
     app.window = window_create();
@@ -438,6 +456,7 @@ void app_deinit(void) {
 
     tick_timer_service_unsubscribe();
     window_destroy(app.window);
+    timing_deinit();
 }
 
 int main(void) {
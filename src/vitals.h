@@ -36,11 +36,13 @@ typedef enum {
     VitalsStateSettings
 } VitalsState;
 
+// every setting is an int so the settings table can address them uniformly
 typedef struct {
     int timeout;
     int delay;
-    bool vibrate;
-    bool seconds_hand;
+    int vibrate;
+    int seconds_hand;
+    int cues;           // VitalsCueSchedule
 } VitalsSettings;
 
 typedef struct {
@@ -63,10 +65,7 @@ typedef struct {
     char num_buffer[4];
 
     int timer_seconds;
-
-    int last_tm_yday;
-    int last_tm_hour;
-    int last_tm_min;
+    struct tm render_time;
 
     VitalsState state;
     
@@ -77,5 +76,7 @@ typedef struct {
 } VitalsApplication;
 
 void app_set_state(VitalsState new_state);
+int app_count_start_seconds();
+int app_count_elapsed_seconds();
 
 extern VitalsApplication app;
\ No newline at end of file
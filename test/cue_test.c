@@ -0,0 +1,164 @@
+/***
+    Copyright 2014 Carl Edwards
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing,
+    software distributed under the License is distributed on an
+    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+    KIND, either express or implied.  See the License for the
+    specific language governing permissions and limitations
+    under the License.
+*/
+
+#include "host.h"
+#include "vitals.h"
+#include "cues.h"
+#include "timing.h"
+
+/*
+    Runs a count for every cue schedule with every delay and timeout the
+    settings offer, one simulated second at a time, and checks the haptics
+    of each second against the cue rules:
+      - a countdown tick on ticks 1..delay-1
+      - the halfway mark when timeout/2 seconds of the count have passed
+      - the 3-2-1 on the ticks with 3, 2 and 1 seconds of the count left
+      - the double pulse when the count starts and when it ends
+    The cue a second played is told apart by its motor-on ms.  The total
+    a count reports to the timing page must be the sum of what played,
+    every second must redraw the hands once, and turning Vibration off
+    must silence all of it.
+*/
+
+#define DELAY_TICK_MS 30
+#define HALFWAY_MS 120
+#define FINAL_MS 80
+
+static const int DELAYS[] = { 3, 5, 10 };
+static const int TIMEOUTS[] = { 15, 30, 60 };
+
+// 2015-03-14 09:00:00 UTC
+#define FIRST_COUNT 1426323600
+
+static int failures;
+static time_t next_count = FIRST_COUNT;
+
+static bool schedule_has(VitalsCueSchedule schedule, int cue_ms) {
+    switch (cue_ms) {
+    case DELAY_TICK_MS:
+        return schedule == VitalsCuesCountdown || schedule == VitalsCuesAll;
+    case HALFWAY_MS:
+    case FINAL_MS:
+        return schedule == VitalsCuesFinal || schedule == VitalsCuesAll;
+    }
+    return false;
+}
+
+// the motor-on ms of the cue tick k of a count should play, 0 for none
+static int expected_tick_cue(VitalsCueSchedule schedule, int delay, int timeout, int k) {
+    int cue_ms = 0;
+    int count_seconds = k - delay;
+    int remaining = timeout - count_seconds;
+    if (k < delay) {
+        cue_ms = DELAY_TICK_MS;
+    }
+    else if (count_seconds == timeout / 2) {
+        cue_ms = HALFWAY_MS;
+    }
+    else if (remaining >= 1 && remaining <= 3) {
+        cue_ms = FINAL_MS;
+    }
+    return schedule_has(schedule, cue_ms) ? cue_ms : 0;
+}
+
+// one count, started half way into a second so each tick and the start and
+// end timers land in different halves of each simulated second
+static void run_count(VitalsCueSchedule schedule, int delay, int timeout, bool vibrate) {
+    app.settings.cues = schedule;
+    app.settings.delay = delay;
+    app.settings.timeout = timeout;
+    app.settings.vibrate = vibrate;
+
+    const TimingScheduleCost *cost = timing_schedule_cost(schedule);
+    int counts_before = cost->counts;
+    uint32_t motor_on_before = cost->motor_on_ms;
+    int count_failures = 0;
+    int played_ms = 0;
+
+    host_set_time(next_count, 500);
+    next_count += 120;
+    host_click(BUTTON_ID_SELECT);
+
+    for (int k = 1; k <= delay + timeout; k++) {
+        host_reset_counters();
+        host_advance_ms(1000);
+
+        int cue_ms = vibrate ? expected_tick_cue(schedule, delay, timeout, k) : 0;
+        int double_pulses = vibrate && (k == delay || k == delay + timeout) ? 1 : 0;
+        bool ok = host_counters.vibe_patterns == (cue_ms ? 1 : 0) &&
+            host_counters.vibe_on_ms == cue_ms &&
+            host_counters.vibe_double_pulses == double_pulses &&
+            host_counters.layer_mark_dirty_calls == 1;
+        if (ok == false) {
+            printf("%-8s FAIL schedule %d delay %2d timeout %2d tick %2d: %d patterns %dms, %d double pulses, %d redraws;"
+                " expected %dms, %d double pulses, 1 redraw\n",
+                HOST_PLATFORM_NAME, schedule, delay, timeout, k, host_counters.vibe_patterns, host_counters.vibe_on_ms,
+                host_counters.vibe_double_pulses, host_counters.layer_mark_dirty_calls, cue_ms, double_pulses);
+            count_failures++;
+        }
+        played_ms += host_counters.vibe_on_ms + host_counters.vibe_double_pulses * CUES_DOUBLE_PULSE_MOTOR_ON_MS;
+    }
+
+    if (app.state != VitalsStateWatch) {
+        printf("%-8s FAIL schedule %d delay %2d timeout %2d: count did not end\n", HOST_PLATFORM_NAME, schedule, delay, timeout);
+        count_failures++;
+    }
+
+    // a silenced count plays no end cue, so it reports nothing
+    int counts_added = cost->counts - counts_before;
+    int reported_ms = (int)(cost->motor_on_ms - motor_on_before);
+    if (counts_added != (vibrate ? 1 : 0) || reported_ms != played_ms) {
+        printf("%-8s FAIL schedule %d delay %2d timeout %2d: reported %d counts %dms, played %dms\n",
+            HOST_PLATFORM_NAME, schedule, delay, timeout, counts_added, reported_ms, played_ms);
+        count_failures++;
+    }
+    failures += count_failures;
+}
+
+int main(void) {
+    host_set_time(FIRST_COUNT - 60, 0);
+    app_init();
+
+    for (VitalsCueSchedule schedule = 0; schedule < VitalsCuesScheduleCount; schedule++) {
+        int failures_before = failures;
+        for (size_t d = 0; d < ARRAY_LENGTH(DELAYS); d++) {
+            for (size_t t = 0; t < ARRAY_LENGTH(TIMEOUTS); t++) {
+                run_count(schedule, DELAYS[d], TIMEOUTS[t], true);
+            }
+        }
+        printf("%-8s %-4s schedule %d, %zu delay/timeout pairs, %d ms per count on average\n",
+            HOST_PLATFORM_NAME, failures == failures_before ? "ok" : "FAIL", schedule,
+            ARRAY_LENGTH(DELAYS) * ARRAY_LENGTH(TIMEOUTS), timing_schedule_cost(schedule)->counts ?
+            (int)(timing_schedule_cost(schedule)->motor_on_ms / timing_schedule_cost(schedule)->counts) : 0);
+    }
+
+    int failures_before = failures;
+    for (VitalsCueSchedule schedule = 0; schedule < VitalsCuesScheduleCount; schedule++) {
+        run_count(schedule, 10, 60, false);
+    }
+    printf("%-8s %-4s Vibration off silences every schedule\n", HOST_PLATFORM_NAME, failures == failures_before ? "ok" : "FAIL");
+
+    if (failures) {
+        printf("%s: %d failures\n", HOST_PLATFORM_NAME, failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+/***
+    Copyright 2014 Carl Edwards
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing,
+    software distributed under the License is distributed on an
+    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+    KIND, either express or implied.  See the License for the
+    specific language governing permissions and limitations
+    under the License.
+*/
+
+#include "host.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/*
+    Renders the app through a scripted session and compares every frame
+    against test/golden/<platform>/<frame>.png.  The pixel writes for each
+    frame, and the drawn pixels that changed since the previous frame, are
+    checked against test/golden/<platform>/frames.csv, so overdraw and
+    redraw regressions fail too.  The gap between the two is what a
+    dirty-rect or cached redraw could save.
+
+    UPDATE_GOLDEN=1 rewrites the golden files instead of comparing.  A
+    mismatching frame is written to test/out/<platform>/ for inspection.
+*/
+
+#define GOLDEN_DIR TEST_DIR "/golden/" HOST_PLATFORM_NAME
+#define OUT_DIR TEST_DIR "/out/" HOST_PLATFORM_NAME
+#define MAX_FRAMES 32
+
+typedef struct {
+    char name[32];
+    int writes;
+    int changed;
+} FrameCount;
+
+static bool update_golden;
+static int failures;
+static FrameCount counts[MAX_FRAMES];
+static int num_counts;
+
+// 2015-03-14 00:00:00 UTC, a Saturday
+#define TEST_DAY 1426291200
+
+static time_t at(int hour, int minute, int second) {
+    return TEST_DAY + hour * 3600 + minute * 60 + second;
+}
+
+static void check_frame(const char *name) {
+    static HostFrame frame;
+    static HostFrame golden;
+    char path[256];
+
+    host_render(&frame);
+    FrameCount *count = &counts[num_counts++];
+    snprintf(count->name, sizeof(count->name), "%s", name);
+    count->writes = frame.writes;
+    count->changed = frame.changed;
+    printf("%-8s %-22s writes %6d  changed %6d\n", HOST_PLATFORM_NAME, name, frame.writes, frame.changed);
+
+    snprintf(path, sizeof(path), "%s/%s.png", GOLDEN_DIR, name);
+    if (update_golden) {
+        if (host_frame_write_png(&frame, path) == false) {
+            printf("FAIL %s: cannot write %s\n", name, path);
+            failures++;
+        }
+        return;
+    }
+    if (host_frame_read_png(&golden, path) == false) {
+        printf("FAIL %s: missing golden %s\n", name, path);
+        failures++;
+        return;
+    }
+    int different = host_frame_diff(&frame, &golden);
+    if (different) {
+        snprintf(path, sizeof(path), "%s/%s.png", OUT_DIR, name);
+        host_frame_write_png(&frame, path);
+        printf("FAIL %s: %d pixels differ, wrote %s\n", name, different, path);
+        failures++;
+    }
+}
+
+static void check_counts() {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/frames.csv", update_golden ? GOLDEN_DIR : OUT_DIR);
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        printf("FAIL cannot write %s\n", path);
+        failures++;
+        return;
+    }
+    fprintf(out, "frame,writes,changed\n");
+    for (int i = 0; i < num_counts; i++) {
+        fprintf(out, "%s,%d,%d\n", counts[i].name, counts[i].writes, counts[i].changed);
+    }
+    fclose(out);
+    if (update_golden) {
+        return;
+    }
+
+    snprintf(path, sizeof(path), "%s/frames.csv", GOLDEN_DIR);
+    FILE *in = fopen(path, "r");
+    if (in == NULL) {
+        printf("FAIL missing golden %s\n", path);
+        failures++;
+        return;
+    }
+    char line[128];
+    int i = 0;
+    fgets(line, sizeof(line), in);
+    while (fgets(line, sizeof(line), in) && i < num_counts) {
+        char expected[160];
+        snprintf(expected, sizeof(expected), "%.31s,%d,%d\n", counts[i].name, counts[i].writes, counts[i].changed);
+        if (strcmp(line, expected) != 0) {
+            printf("FAIL pixel counts: expected %s       got %s", line, expected);
+            failures++;
+        }
+        i++;
+    }
+    if (i != num_counts) {
+        printf("FAIL pixel counts: golden has %d frames, rendered %d\n", i, num_counts);
+        failures++;
+    }
+    fclose(in);
+}
+
+int main(void) {
+    update_golden = getenv("UPDATE_GOLDEN") != NULL;
+    mkdir(TEST_DIR "/out", 0755);
+    mkdir(OUT_DIR, 0755);
+    mkdir(TEST_DIR "/golden", 0755);
+    mkdir(GOLDEN_DIR, 0755);
+
+    host_set_time(at(10, 9, 0), 0);
+    app_init();
+
+    // watch mode, one sample per date location plus a day change
+    host_jump_to(at(10, 10, 30));
+    check_frame("watch_10_10_30");      // Bottom
+    host_jump_to(at(4, 35, 45));
+    check_frame("watch_04_35_45");      // Top
+    host_jump_to(at(1, 20, 5));
+    check_frame("watch_01_20_05");      // Left
+    host_jump_to(at(8, 50, 50));
+    check_frame("watch_08_50_50");      // Right
+    host_jump_to(at(24, 0, 15));
+    check_frame("watch_00_00_15");      // next day
+
+    // count pulses mode: the delay, the count itself, then back to the watch
+    host_jump_to(at(24 + 9, 0, 0));
+    host_click(BUTTON_ID_SELECT);
+    host_advance_ms(2000);
+    check_frame("count_delay");
+    host_advance_ms(10000);
+    check_frame("count_running");
+    host_advance_ms(60000);
+    check_frame("count_finished");
+
+    // settings, reached with a long-press, and the hidden timing page behind it
+    host_long_click(BUTTON_ID_SELECT);
+    check_frame("settings");
+    host_click(BUTTON_ID_DOWN);
+    host_click(BUTTON_ID_DOWN);
+    host_click(BUTTON_ID_DOWN);
+    host_click(BUTTON_ID_SELECT);
+    check_frame("settings_changed");
+    host_long_click(BUTTON_ID_SELECT);
+    check_frame("timing_page");
+    host_click(BUTTON_ID_BACK);
+    host_click(BUTTON_ID_BACK);
+    check_frame("settings_closed");
+
+    check_counts();
+    if (failures) {
+        printf("%s: %d failures\n", HOST_PLATFORM_NAME, failures);
+        return 1;
+    }
+    printf("%s: %d frames %s\n", HOST_PLATFORM_NAME, num_counts, update_golden ? "written" : "match");
+    return 0;
+}
@@ -0,0 +1,1256 @@
+/***
+    Copyright 2014 Carl Edwards
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing,
+    software distributed under the License is distributed on an
+    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+    KIND, either express or implied.  See the License for the
+    specific language governing permissions and limitations
+    under the License.
+*/
+
+#define HOST_IMPLEMENTATION
+#include "host.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <png.h>
+
+/*
+    The stand-in rasterizes into a GColor8 framebuffer with simple, fixed
+    rules (Bresenham lines, scanline polygon fill, midpoint circles).  It is
+    not pixel-identical to the watch firmware; it only has to be deterministic
+    so rendering changes show up as golden-frame diffs.  Text is drawn as one
+    placeholder 5x7 cell per character whose pattern is unique to that
+    character, so content, length, position and alignment all show up.
+*/
+
+HostCounters host_counters;
+
+void host_reset_counters() {
+    memset(&host_counters, 0, sizeof(host_counters));
+}
+
+// ------------------------------------------------------------------ logging
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...) {
+    if (getenv("HOST_LOG") == NULL) {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "%s:%d ", src_filename, src_line_number);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+// ------------------------------------------------------------------ math
+
+int32_t sin_lookup(int32_t angle) {
+    return (int32_t)lround(sin(angle * 2.0 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle) {
+    return (int32_t)lround(cos(angle * 2.0 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+GPoint grect_center_point(const GRect *rect) {
+    return GPoint(rect->origin.x + rect->size.w / 2, rect->origin.y + rect->size.h / 2);
+}
+
+static GRect grect_intersect(GRect a, GRect b) {
+    int x0 = a.origin.x > b.origin.x ? a.origin.x : b.origin.x;
+    int y0 = a.origin.y > b.origin.y ? a.origin.y : b.origin.y;
+    int x1 = a.origin.x + a.size.w < b.origin.x + b.size.w ? a.origin.x + a.size.w : b.origin.x + b.size.w;
+    int y1 = a.origin.y + a.size.h < b.origin.y + b.size.h ? a.origin.y + a.size.h : b.origin.y + b.size.h;
+    return GRect(x0, y0, x1 > x0 ? x1 - x0 : 0, y1 > y0 ? y1 - y0 : 0);
+}
+
+// ------------------------------------------------------------------ clock
+
+static int64_t clock_ms;
+
+int64_t host_now_ms() {
+    return clock_ms;
+}
+
+time_t host_time(time_t *tloc) {
+    time_t seconds = (time_t)(clock_ms / 1000);
+    if (tloc) {
+        *tloc = seconds;
+    }
+    return seconds;
+}
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms) {
+    uint16_t ms = (uint16_t)(clock_ms % 1000);
+    host_time(tloc);
+    if (out_ms) {
+        *out_ms = ms;
+    }
+    return ms;
+}
+
+struct tm *host_localtime(const time_t *timep) {
+    static struct tm result;
+    gmtime_r(timep, &result);
+    return &result;
+}
+
+size_t host_strftime(char *s, size_t max, const char *format, const struct tm *tm) {
+    host_counters.strftime_calls++;
+    return strftime(s, max, format, tm);
+}
+
+// ------------------------------------------------------------------ framebuffer
+
+struct GContext {
+    GPoint offset;      // screen position of the layer's bounds origin
+    GRect clip;         // screen space
+    GColor stroke;
+    GColor fill;
+    GColor text;
+};
+
+static HostFrame *target;
+static bool drawn[HOST_HEIGHT][HOST_WIDTH];
+static uint8_t previous[HOST_HEIGHT][HOST_WIDTH];
+
+static void put_pixel(GContext *ctx, int x, int y, GColor color) {
+    if (color.argb >> 6 == 0) {
+        return;
+    }
+    x += ctx->offset.x;
+    y += ctx->offset.y;
+    if (x < ctx->clip.origin.x || y < ctx->clip.origin.y ||
+        x >= ctx->clip.origin.x + ctx->clip.size.w || y >= ctx->clip.origin.y + ctx->clip.size.h) {
+        return;
+    }
+    target->pixels[y][x] = color.argb;
+    target->writes++;
+    drawn[y][x] = true;
+}
+
+#if defined(PBL_BW)
+// 1-bit displays show each pixel as black or white, by its luminance
+static uint8_t reduce_to_bw(uint8_t argb) {
+    int r = ((argb >> 4) & 3) * 85, g = ((argb >> 2) & 3) * 85, b = (argb & 3) * 85;
+    return (r * 299 + g * 587 + b * 114) / 1000 >= 128 ? GColorWhite.argb : GColorBlack.argb;
+}
+#endif
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {
+    ctx->stroke = color;
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {
+    ctx->fill = color;
+}
+
+void graphics_context_set_text_color(GContext *ctx, GColor color) {
+    ctx->text = color;
+}
+
+void graphics_draw_pixel(GContext *ctx, GPoint point) {
+    put_pixel(ctx, point.x, point.y, ctx->stroke);
+}
+
+static void draw_line(GContext *ctx, int x0, int y0, int x1, int y1, GColor color) {
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        put_pixel(ctx, x0, y0, color);
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1) {
+    draw_line(ctx, p0.x, p0.y, p1.x, p1.y, ctx->stroke);
+}
+
+static void fill_rect(GContext *ctx, GRect rect, GColor color) {
+    for (int y = rect.origin.y; y < rect.origin.y + rect.size.h; y++) {
+        for (int x = rect.origin.x; x < rect.origin.x + rect.size.w; x++) {
+            put_pixel(ctx, x, y, color);
+        }
+    }
+}
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, int corner_mask) {
+    fill_rect(ctx, rect, ctx->fill);
+}
+
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius) {
+    int x = radius, y = 0, err = 1 - x;
+    while (x >= y) {
+        const int points[8][2] = {
+            { x, y }, { y, x }, { -y, x }, { -x, y }, { -x, -y }, { -y, -x }, { y, -x }, { x, -y }
+        };
+        for (int i = 0; i < 8; i++) {
+            put_pixel(ctx, p.x + points[i][0], p.y + points[i][1], ctx->stroke);
+        }
+        y++;
+        if (err < 0) {
+            err += 2 * y + 1;
+        }
+        else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius) {
+    int r = radius;
+    for (int dy = -r; dy <= r; dy++) {
+        for (int dx = -r; dx <= r; dx++) {
+            if (dx * dx + dy * dy <= r * r + r) {
+                put_pixel(ctx, p.x + dx, p.y + dy, ctx->fill);
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------ paths
+
+GPath *gpath_create(const GPathInfo *init) {
+    GPath *path = calloc(1, sizeof(GPath));
+    path->num_points = init->num_points;
+    path->points = malloc(sizeof(GPoint) * init->num_points);
+    memcpy(path->points, init->points, sizeof(GPoint) * init->num_points);
+    return path;
+}
+
+void gpath_destroy(GPath *path) {
+    free(path->points);
+    free(path);
+}
+
+void gpath_rotate_to(GPath *path, int32_t angle) {
+    path->rotation = angle;
+}
+
+void gpath_move_to(GPath *path, GPoint point) {
+    path->offset = point;
+}
+
+static void gpath_transform(const GPath *path, GPoint *out) {
+    int32_t s = sin_lookup(path->rotation);
+    int32_t c = cos_lookup(path->rotation);
+    for (uint32_t i = 0; i < path->num_points; i++) {
+        int32_t x = path->points[i].x, y = path->points[i].y;
+        out[i].x = (int16_t)((x * c - y * s) / TRIG_MAX_RATIO) + path->offset.x;
+        out[i].y = (int16_t)((x * s + y * c) / TRIG_MAX_RATIO) + path->offset.y;
+    }
+}
+
+void gpath_draw_filled(GContext *ctx, GPath *path) {
+    GPoint points[path->num_points];
+    gpath_transform(path, points);
+
+    int min_y = points[0].y, max_y = points[0].y;
+    for (uint32_t i = 1; i < path->num_points; i++) {
+        min_y = points[i].y < min_y ? points[i].y : min_y;
+        max_y = points[i].y > max_y ? points[i].y : max_y;
+    }
+
+    // even-odd scanline fill sampled at pixel centers
+    for (int y = min_y; y <= max_y; y++) {
+        double crossings[path->num_points];
+        int count = 0;
+        double sample_y = y + 0.5;
+        for (uint32_t i = 0; i < path->num_points; i++) {
+            GPoint a = points[i], b = points[(i + 1) % path->num_points];
+            if ((a.y <= sample_y && b.y > sample_y) || (b.y <= sample_y && a.y > sample_y)) {
+                crossings[count++] = a.x + (sample_y - a.y) * (b.x - a.x) / (double)(b.y - a.y);
+            }
+        }
+        for (int i = 1; i < count; i++) {
+            for (int j = i; j > 0 && crossings[j - 1] > crossings[j]; j--) {
+                double swap = crossings[j];
+                crossings[j] = crossings[j - 1];
+                crossings[j - 1] = swap;
+            }
+        }
+        for (int i = 0; i + 1 < count; i += 2) {
+            for (int x = (int)ceil(crossings[i] - 0.5); x <= (int)floor(crossings[i + 1] - 0.5); x++) {
+                put_pixel(ctx, x, y, ctx->fill);
+            }
+        }
+    }
+}
+
+void gpath_draw_outline(GContext *ctx, GPath *path) {
+    GPoint points[path->num_points];
+    gpath_transform(path, points);
+    for (uint32_t i = 0; i < path->num_points; i++) {
+        GPoint a = points[i], b = points[(i + 1) % path->num_points];
+        draw_line(ctx, a.x, a.y, b.x, b.y, ctx->stroke);
+    }
+}
+
+// ------------------------------------------------------------------ text
+
+struct HostFont {
+    const char *key;
+    int line_height;
+    int scale;
+    bool bold;
+};
+
+static const struct HostFont FONTS[] = {
+    { FONT_KEY_GOTHIC_14, 14, 1, false },
+    { FONT_KEY_GOTHIC_14_BOLD, 14, 1, true },
+    { FONT_KEY_GOTHIC_18, 18, 1, false },
+    { FONT_KEY_GOTHIC_18_BOLD, 18, 1, true },
+    { FONT_KEY_GOTHIC_24, 24, 2, false },
+    { FONT_KEY_GOTHIC_24_BOLD, 24, 2, true },
+};
+
+GFont fonts_get_system_font(const char *font_key) {
+    for (size_t i = 0; i < ARRAY_LENGTH(FONTS); i++) {
+        if (strcmp(FONTS[i].key, font_key) == 0) {
+            return &FONTS[i];
+        }
+    }
+    return &FONTS[0];
+}
+
+#define GLYPH_W 5
+#define GLYPH_H 7
+
+static int glyph_advance(GFont font) {
+    return (GLYPH_W + 1) * font->scale;
+}
+
+static void draw_glyph(GContext *ctx, int x, int y, char c, GFont font, GColor color) {
+    // multiplying by an odd constant is a bijection, so every character gets its own pattern
+    uint32_t pattern = (uint32_t)(unsigned char)c * 2654435761u;
+    if (c == ' ') {
+        return;
+    }
+    for (int row = 0; row < GLYPH_H; row++) {
+        for (int col = 0; col < GLYPH_W; col++) {
+            int bit = row * GLYPH_W + col;
+            if (bit >= 32 || ((pattern >> bit) & 1) == 0) {
+                continue;
+            }
+            GRect cell = GRect(x + col * font->scale, y + row * font->scale, font->scale + (font->bold ? 1 : 0), font->scale);
+            fill_rect(ctx, cell, color);
+        }
+    }
+}
+
+static void draw_text_line(GContext *ctx, const char *text, int length, GFont font, GRect box, int y, GTextAlignment alignment, GColor color) {
+    int width = length * glyph_advance(font) - font->scale;
+    int x = box.origin.x;
+    if (alignment == GTextAlignmentCenter) {
+        x += (box.size.w - width) / 2;
+    }
+    else if (alignment == GTextAlignmentRight) {
+        x += box.size.w - width;
+    }
+    for (int i = 0; i < length; i++) {
+        draw_glyph(ctx, x + i * glyph_advance(font), y, text[i], font, color);
+    }
+}
+
+// newlines break lines, and lines wider than the box wrap at the character that overflows
+static void draw_text(GContext *ctx, const char *text, GFont font, GRect box, GTextAlignment alignment, GColor color) {
+    int per_line = box.size.w / glyph_advance(font);
+    int y = box.origin.y + (font->line_height - GLYPH_H * font->scale) / 2;
+    if (per_line < 1) {
+        return;
+    }
+    while (*text) {
+        int length = 0;
+        while (text[length] && text[length] != '\n' && length < per_line) {
+            length++;
+        }
+        draw_text_line(ctx, text, length, font, box, y, alignment, color);
+        text += length;
+        if (*text == '\n') {
+            text++;
+        }
+        y += font->line_height;
+    }
+}
+
+// ------------------------------------------------------------------ bitmaps
+
+struct GBitmap {
+    int width;
+    int height;
+    uint8_t *pixels;    // GColor8 argb
+};
+
+static const char *RESOURCE_FILES[] = {
+    [RESOURCE_ID_IMAGE_MENU_ICON] = "images/caduceus_icon",
+    [RESOURCE_ID_WATCHFACE_BACKGROUND] = "images/watch-background",
+    [RESOURCE_ID_HEART] = "images/heart",
+};
+
+static uint8_t rgba_to_argb8(const uint8_t *rgba) {
+#if defined(PBL_BW)
+    int luminance = (rgba[0] * 299 + rgba[1] * 587 + rgba[2] * 114) / 1000;
+    uint8_t rgb = luminance >= 128 ? 0x3F : 0x00;
+#else
+    uint8_t rgb = (rgba[0] >> 6) << 4 | (rgba[1] >> 6) << 2 | (rgba[2] >> 6);
+#endif
+    return (rgba[3] >> 6) << 6 | rgb;
+}
+
+static bool load_png(const char *path, GBitmap *bitmap) {
+    png_image image;
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_file(&image, path)) {
+        return false;
+    }
+    image.format = PNG_FORMAT_RGBA;
+    uint8_t *rgba = malloc(PNG_IMAGE_SIZE(image));
+    if (!png_image_finish_read(&image, NULL, rgba, 0, NULL)) {
+        free(rgba);
+        return false;
+    }
+    bitmap->width = image.width;
+    bitmap->height = image.height;
+    bitmap->pixels = malloc(image.width * image.height);
+    for (size_t i = 0; i < image.width * image.height; i++) {
+        bitmap->pixels[i] = rgba_to_argb8(&rgba[i * 4]);
+    }
+    free(rgba);
+    return true;
+}
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id) {
+    // the same file tag fallbacks the SDK resource build applies for each platform
+    static const char *TAGS[] = {
+#if defined(PBL_ROUND)
+        "~round",
+#endif
+#if defined(PBL_BW)
+        "~bw",
+#else
+        "~color",
+#endif
+        "",
+    };
+    GBitmap *bitmap = calloc(1, sizeof(GBitmap));
+    for (size_t i = 0; i < ARRAY_LENGTH(TAGS); i++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s%s.png", RESOURCES_DIR, RESOURCE_FILES[resource_id], TAGS[i]);
+        if (load_png(path, bitmap)) {
+            return bitmap;
+        }
+    }
+    fprintf(stderr, "missing resource %s\n", RESOURCE_FILES[resource_id]);
+    abort();
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+    free(bitmap->pixels);
+    free(bitmap);
+}
+
+// ------------------------------------------------------------------ layers
+
+typedef void (*LayerRenderProc)(Layer *layer, GContext *ctx);
+
+struct Layer {
+    GRect frame;
+    GRect bounds;
+    Layer *parent;
+    Layer *first_child;
+    Layer *next_sibling;
+    bool hidden;
+    LayerUpdateProc update_proc;
+    LayerRenderProc render_proc;    // built-in drawing of text, bitmap and menu layers
+};
+
+static void layer_init(Layer *layer, GRect frame) {
+    memset(layer, 0, sizeof(Layer));
+    layer->frame = frame;
+    layer->bounds = GRect(0, 0, frame.size.w, frame.size.h);
+}
+
+static void layer_remove_from_parent(Layer *layer) {
+    if (layer->parent == NULL) {
+        return;
+    }
+    Layer **link = &layer->parent->first_child;
+    while (*link != layer) {
+        link = &(*link)->next_sibling;
+    }
+    *link = layer->next_sibling;
+    layer->parent = NULL;
+    layer->next_sibling = NULL;
+}
+
+Layer *layer_create(GRect frame) {
+    Layer *layer = malloc(sizeof(Layer));
+    layer_init(layer, frame);
+    return layer;
+}
+
+void layer_destroy(Layer *layer) {
+    layer_remove_from_parent(layer);
+    free(layer);
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+    layer->update_proc = update_proc;
+}
+
+void layer_mark_dirty(Layer *layer) {
+    host_counters.layer_mark_dirty_calls++;
+}
+
+void layer_set_frame(Layer *layer, GRect frame) {
+    host_counters.layer_set_frame_calls++;
+    layer->frame = frame;
+    layer->bounds.size = frame.size;
+}
+
+GRect layer_get_frame(const Layer *layer) {
+    return layer->frame;
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+    return layer->bounds;
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+    layer->hidden = hidden;
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+    layer_remove_from_parent(child);
+    Layer **link = &parent->first_child;
+    while (*link) {
+        link = &(*link)->next_sibling;
+    }
+    *link = child;
+    child->parent = parent;
+}
+
+static void render_layer(Layer *layer, GPoint parent_origin, GRect parent_clip) {
+    if (layer->hidden) {
+        return;
+    }
+    GPoint origin = GPoint(parent_origin.x + layer->frame.origin.x, parent_origin.y + layer->frame.origin.y);
+    GRect clip = grect_intersect(parent_clip, GRect(origin.x, origin.y, layer->frame.size.w, layer->frame.size.h));
+    GPoint bounds_origin = GPoint(origin.x + layer->bounds.origin.x, origin.y + layer->bounds.origin.y);
+
+    GContext ctx = { bounds_origin, clip, GColorBlack, GColorBlack, GColorBlack };
+    if (layer->render_proc) {
+        layer->render_proc(layer, &ctx);
+    }
+    if (layer->update_proc) {
+        layer->update_proc(layer, &ctx);
+    }
+    for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+        render_layer(child, bounds_origin, clip);
+    }
+}
+
+// ------------------------------------------------------------------ text layer
+
+struct TextLayer {
+    Layer layer;
+    const char *text;
+    GColor background_color;
+    GColor text_color;
+    GTextAlignment alignment;
+    GFont font;
+};
+
+static void text_layer_render(Layer *layer, GContext *ctx) {
+    TextLayer *text_layer = (TextLayer *)layer;
+    fill_rect(ctx, layer->bounds, text_layer->background_color);
+    if (text_layer->text) {
+        draw_text(ctx, text_layer->text, text_layer->font, layer->bounds, text_layer->alignment, text_layer->text_color);
+    }
+}
+
+TextLayer *text_layer_create(GRect frame) {
+    TextLayer *text_layer = calloc(1, sizeof(TextLayer));
+    layer_init(&text_layer->layer, frame);
+    text_layer->layer.render_proc = text_layer_render;
+    text_layer->background_color = GColorWhite;
+    text_layer->text_color = GColorBlack;
+    text_layer->alignment = GTextAlignmentLeft;
+    text_layer->font = fonts_get_system_font(FONT_KEY_GOTHIC_14_BOLD);
+    return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer) {
+    layer_remove_from_parent(&text_layer->layer);
+    free(text_layer);
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer) {
+    return &text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text) {
+    host_counters.text_layer_set_text_calls++;
+    text_layer->text = text;
+}
+
+void text_layer_set_background_color(TextLayer *text_layer, GColor color) {
+    text_layer->background_color = color;
+}
+
+void text_layer_set_text_color(TextLayer *text_layer, GColor color) {
+    text_layer->text_color = color;
+}
+
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment) {
+    text_layer->alignment = text_alignment;
+}
+
+void text_layer_set_font(TextLayer *text_layer, GFont font) {
+    text_layer->font = font;
+}
+
+// ------------------------------------------------------------------ bitmap layer
+
+struct BitmapLayer {
+    Layer layer;
+    const GBitmap *bitmap;
+    GAlign alignment;
+};
+
+static void bitmap_layer_render(Layer *layer, GContext *ctx) {
+    BitmapLayer *bitmap_layer = (BitmapLayer *)layer;
+    const GBitmap *bitmap = bitmap_layer->bitmap;
+    if (bitmap == NULL) {
+        return;
+    }
+    int x0 = 0, y0 = 0;
+    if (bitmap_layer->alignment == GAlignCenter) {
+        x0 = (layer->bounds.size.w - bitmap->width) / 2;
+        y0 = (layer->bounds.size.h - bitmap->height) / 2;
+    }
+    // pixels that are at least half opaque are copied, the rest are skipped
+    for (int y = 0; y < bitmap->height; y++) {
+        for (int x = 0; x < bitmap->width; x++) {
+            uint8_t argb = bitmap->pixels[y * bitmap->width + x];
+            if (argb >> 6 >= 2) {
+                put_pixel(ctx, x0 + x, y0 + y, (GColor8){ .argb = 0xC0 | argb });
+            }
+        }
+    }
+}
+
+BitmapLayer *bitmap_layer_create(GRect frame) {
+    BitmapLayer *bitmap_layer = calloc(1, sizeof(BitmapLayer));
+    layer_init(&bitmap_layer->layer, frame);
+    bitmap_layer->layer.render_proc = bitmap_layer_render;
+    bitmap_layer->alignment = GAlignTopLeft;
+    return bitmap_layer;
+}
+
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer) {
+    layer_remove_from_parent(&bitmap_layer->layer);
+    free(bitmap_layer);
+}
+
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer) {
+    return (Layer *)&bitmap_layer->layer;
+}
+
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap) {
+    bitmap_layer->bitmap = bitmap;
+}
+
+void bitmap_layer_set_alignment(BitmapLayer *bitmap_layer, GAlign alignment) {
+    bitmap_layer->alignment = alignment;
+}
+
+// ------------------------------------------------------------------ windows
+
+struct Window {
+    Layer root;
+    GColor background_color;
+    WindowHandlers handlers;
+    ClickConfigProvider click_config_provider;
+    void *click_config_context;
+    bool loaded;
+    ClickHandler single_click[NUM_BUTTONS];
+    ClickHandler long_click[NUM_BUTTONS];
+};
+
+#define WINDOW_STACK_SIZE 8
+
+static Window *window_stack[WINDOW_STACK_SIZE];
+static int window_stack_count;
+static Window *configuring_window;
+
+Window *window_create(void) {
+    Window *window = calloc(1, sizeof(Window));
+    layer_init(&window->root, GRect(0, 0, HOST_WIDTH, HOST_HEIGHT));
+    window->background_color = GColorWhite;
+    window->click_config_context = window;
+    return window;
+}
+
+void window_destroy(Window *window) {
+    free(window);
+}
+
+Layer *window_get_root_layer(const Window *window) {
+    return (Layer *)&window->root;
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+    window->handlers = handlers;
+}
+
+void window_set_background_color(Window *window, GColor background_color) {
+    window->background_color = background_color;
+}
+
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider) {
+    window_set_click_config_provider_with_context(window, click_config_provider, window);
+}
+
+void window_set_click_config_provider_with_context(Window *window, ClickConfigProvider click_config_provider, void *context) {
+    window->click_config_provider = click_config_provider;
+    window->click_config_context = context;
+}
+
+ClickConfigProvider window_get_click_config_provider(const Window *window) {
+    return window->click_config_provider;
+}
+
+void *window_get_click_config_context(Window *window) {
+    return window->click_config_context;
+}
+
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler) {
+    configuring_window->single_click[button_id] = handler;
+}
+
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler, ClickHandler up_handler) {
+    configuring_window->long_click[button_id] = down_handler;
+}
+
+Window *host_top_window() {
+    return window_stack_count ? window_stack[window_stack_count - 1] : NULL;
+}
+
+static void window_became_top(Window *window) {
+    memset(window->single_click, 0, sizeof(window->single_click));
+    memset(window->long_click, 0, sizeof(window->long_click));
+    if (window->handlers.appear) {
+        window->handlers.appear(window);
+    }
+    if (window->click_config_provider) {
+        configuring_window = window;
+        window->click_config_provider(window->click_config_context);
+        configuring_window = NULL;
+    }
+}
+
+void window_stack_push(Window *window, bool animated) {
+    if (window_stack_contains_window(window)) {
+        return;
+    }
+    Window *previous = host_top_window();
+    if (previous && previous->handlers.disappear) {
+        previous->handlers.disappear(previous);
+    }
+    window_stack[window_stack_count++] = window;
+    if (!window->loaded) {
+        window->loaded = true;
+        if (window->handlers.load) {
+            window->handlers.load(window);
+        }
+    }
+    window_became_top(window);
+}
+
+Window *window_stack_pop(bool animated) {
+    Window *window = host_top_window();
+    if (window == NULL) {
+        return NULL;
+    }
+    if (window->handlers.disappear) {
+        window->handlers.disappear(window);
+    }
+    window_stack_count--;
+    window->loaded = false;
+    if (window->handlers.unload) {
+        window->handlers.unload(window);
+    }
+    if (host_top_window()) {
+        window_became_top(host_top_window());
+    }
+    return window;
+}
+
+void window_stack_pop_all(const bool animated) {
+    while (window_stack_count) {
+        window_stack_pop(animated);
+    }
+}
+
+bool window_stack_contains_window(Window *window) {
+    for (int i = 0; i < window_stack_count; i++) {
+        if (window_stack[i] == window) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void host_click(ButtonId button) {
+    Window *window = host_top_window();
+    if (window == NULL) {
+        return;
+    }
+    if (window->single_click[button]) {
+        window->single_click[button](NULL, window->click_config_context);
+    }
+    else if (button == BUTTON_ID_BACK) {
+        window_stack_pop(true);
+    }
+}
+
+void host_long_click(ButtonId button) {
+    Window *window = host_top_window();
+    if (window && window->long_click[button]) {
+        window->long_click[button](NULL, window->click_config_context);
+    }
+}
+
+// ------------------------------------------------------------------ simple menu
+
+#define MENU_HEADER_HEIGHT 16
+#define MENU_CELL_HEIGHT 44
+
+struct SimpleMenuLayer {
+    Layer layer;
+    const SimpleMenuSection *sections;
+    int num_sections;
+    int selected_section;
+    int selected_row;
+    void *callback_context;
+};
+
+static int menu_selected_y(SimpleMenuLayer *menu) {
+    int y = 0;
+    for (int s = 0; s < menu->selected_section; s++) {
+        y += MENU_HEADER_HEIGHT + MENU_CELL_HEIGHT * menu->sections[s].num_items;
+    }
+    return y + MENU_HEADER_HEIGHT + MENU_CELL_HEIGHT * menu->selected_row;
+}
+
+static void simple_menu_layer_render(Layer *layer, GContext *ctx) {
+    SimpleMenuLayer *menu = (SimpleMenuLayer *)layer;
+    int width = layer->bounds.size.w;
+
+    // scroll just far enough to keep the selected row on screen
+    int scroll = menu_selected_y(menu) + MENU_CELL_HEIGHT - layer->bounds.size.h;
+    int y = scroll > 0 ? -scroll : 0;
+
+    fill_rect(ctx, layer->bounds, GColorWhite);
+    for (int s = 0; s < menu->num_sections; s++) {
+        const SimpleMenuSection *section = &menu->sections[s];
+        if (section->title) {
+            draw_text(ctx, section->title, fonts_get_system_font(FONT_KEY_GOTHIC_14_BOLD),
+                GRect(2, y, width - 4, MENU_HEADER_HEIGHT), GTextAlignmentLeft, GColorBlack);
+        }
+        y += MENU_HEADER_HEIGHT;
+        for (uint32_t r = 0; r < section->num_items; r++) {
+            const SimpleMenuItem *item = &section->items[r];
+            bool selected = s == menu->selected_section && (int)r == menu->selected_row;
+            GColor text_color = selected ? GColorWhite : GColorBlack;
+            if (selected) {
+                fill_rect(ctx, GRect(0, y, width, MENU_CELL_HEIGHT), GColorBlack);
+            }
+            if (item->title) {
+                draw_text(ctx, item->title, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD),
+                    GRect(5, y, width - 10, 24), GTextAlignmentLeft, text_color);
+            }
+            if (item->subtitle) {
+                draw_text(ctx, item->subtitle, fonts_get_system_font(FONT_KEY_GOTHIC_18),
+                    GRect(5, y + 24, width - 10, 18), GTextAlignmentLeft, text_color);
+            }
+            y += MENU_CELL_HEIGHT;
+        }
+    }
+}
+
+static void simple_menu_up(ClickRecognizerRef recognizer, void *context) {
+    SimpleMenuLayer *menu = context;
+    if (menu->selected_row > 0) {
+        menu->selected_row--;
+    }
+    else if (menu->selected_section > 0) {
+        menu->selected_section--;
+        menu->selected_row = menu->sections[menu->selected_section].num_items - 1;
+    }
+}
+
+static void simple_menu_down(ClickRecognizerRef recognizer, void *context) {
+    SimpleMenuLayer *menu = context;
+    if (menu->selected_row + 1 < (int)menu->sections[menu->selected_section].num_items) {
+        menu->selected_row++;
+    }
+    else if (menu->selected_section + 1 < menu->num_sections) {
+        menu->selected_section++;
+        menu->selected_row = 0;
+    }
+}
+
+static void simple_menu_select(ClickRecognizerRef recognizer, void *context) {
+    SimpleMenuLayer *menu = context;
+    const SimpleMenuItem *item = &menu->sections[menu->selected_section].items[menu->selected_row];
+    if (item->callback) {
+        item->callback(menu->selected_row, menu->callback_context);
+    }
+}
+
+static void simple_menu_click_config_provider(void *context) {
+    window_single_click_subscribe(BUTTON_ID_UP, simple_menu_up);
+    window_single_click_subscribe(BUTTON_ID_DOWN, simple_menu_down);
+    window_single_click_subscribe(BUTTON_ID_SELECT, simple_menu_select);
+}
+
+SimpleMenuLayer *simple_menu_layer_create(GRect frame, Window *window, const SimpleMenuSection *sections, int32_t num_sections, void *callback_context) {
+    SimpleMenuLayer *menu = calloc(1, sizeof(SimpleMenuLayer));
+    layer_init(&menu->layer, frame);
+    menu->layer.render_proc = simple_menu_layer_render;
+    menu->sections = sections;
+    menu->num_sections = num_sections;
+    menu->callback_context = callback_context;
+    window_set_click_config_provider_with_context(window, simple_menu_click_config_provider, menu);
+    return menu;
+}
+
+void simple_menu_layer_destroy(SimpleMenuLayer *menu_layer) {
+    layer_remove_from_parent(&menu_layer->layer);
+    free(menu_layer);
+}
+
+Layer *simple_menu_layer_get_layer(const SimpleMenuLayer *simple_menu) {
+    return (Layer *)&simple_menu->layer;
+}
+
+void menu_layer_reload_data(MenuLayer *menu_layer) {
+    layer_mark_dirty(&((SimpleMenuLayer *)menu_layer)->layer);
+}
+
+// ------------------------------------------------------------------ timers and ticks
+
+struct AppTimer {
+    int64_t due_ms;
+    AppTimerCallback callback;
+    void *data;
+    bool active;
+};
+
+#define TIMER_POOL_SIZE 16
+
+static AppTimer timers[TIMER_POOL_SIZE];
+static TimeUnits tick_units;
+static TickHandler tick_handler;
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+    for (int i = 0; i < TIMER_POOL_SIZE; i++) {
+        if (!timers[i].active) {
+            timers[i] = (AppTimer){ clock_ms + timeout_ms, callback, callback_data, true };
+            return &timers[i];
+        }
+    }
+    fprintf(stderr, "out of app timers\n");
+    abort();
+}
+
+void app_timer_cancel(AppTimer *timer_handle) {
+    timer_handle->active = false;
+}
+
+static AppTimer *next_timer() {
+    AppTimer *next = NULL;
+    for (int i = 0; i < TIMER_POOL_SIZE; i++) {
+        if (timers[i].active && (next == NULL || timers[i].due_ms < next->due_ms)) {
+            next = &timers[i];
+        }
+    }
+    return next;
+}
+
+static void fire_due_timers() {
+    AppTimer *timer;
+    while ((timer = next_timer()) && timer->due_ms <= clock_ms) {
+        timer->active = false;
+        timer->callback(timer->data);
+    }
+}
+
+void tick_timer_service_subscribe(TimeUnits units, TickHandler handler) {
+    tick_units = units;
+    tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+    tick_handler = NULL;
+}
+
+static void deliver_tick(time_t from, time_t to) {
+    struct tm before, after;
+    gmtime_r(&from, &before);
+    gmtime_r(&to, &after);
+
+    TimeUnits changed = 0;
+    changed |= before.tm_sec != after.tm_sec ? SECOND_UNIT : 0;
+    changed |= before.tm_min != after.tm_min ? MINUTE_UNIT : 0;
+    changed |= before.tm_hour != after.tm_hour ? HOUR_UNIT : 0;
+    changed |= before.tm_yday != after.tm_yday || before.tm_year != after.tm_year ? DAY_UNIT : 0;
+    changed |= before.tm_mon != after.tm_mon ? MONTH_UNIT : 0;
+    changed |= before.tm_year != after.tm_year ? YEAR_UNIT : 0;
+
+    if (tick_handler && (changed & tick_units)) {
+        tick_handler(&after, changed);
+    }
+}
+
+void host_set_time(time_t seconds, uint16_t ms) {
+    clock_ms = (int64_t)seconds * 1000 + ms;
+}
+
+void host_jump_to(time_t seconds) {
+    time_t from = host_time(NULL);
+    clock_ms = (int64_t)seconds * 1000;
+    deliver_tick(from, seconds);
+    fire_due_timers();
+}
+
+void host_advance_ms(int64_t ms) {
+    int64_t end = clock_ms + ms;
+    for (;;) {
+        // ticks land on the second boundary, ahead of any timer due at the same ms
+        int64_t next_second = (clock_ms / 1000 + 1) * 1000;
+        AppTimer *timer = next_timer();
+        int64_t next_event = timer && timer->due_ms < next_second ? timer->due_ms : next_second;
+        if (next_event > end) {
+            break;
+        }
+        clock_ms = next_event;
+        if (next_event == next_second) {
+            deliver_tick(next_second / 1000 - 1, next_second / 1000);
+        }
+        fire_due_timers();
+    }
+    clock_ms = end;
+}
+
+// ------------------------------------------------------------------ other services
+
+#define PERSIST_SLOTS 16
+
+static struct {
+    uint32_t key;
+    int32_t value;
+    bool used;
+} persist_store[PERSIST_SLOTS];
+
+bool persist_exists(const uint32_t key) {
+    for (int i = 0; i < PERSIST_SLOTS; i++) {
+        if (persist_store[i].used && persist_store[i].key == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int32_t persist_read_int(const uint32_t key) {
+    for (int i = 0; i < PERSIST_SLOTS; i++) {
+        if (persist_store[i].used && persist_store[i].key == key) {
+            return persist_store[i].value;
+        }
+    }
+    return 0;
+}
+
+bool persist_read_bool(const uint32_t key) {
+    return persist_read_int(key) != 0;
+}
+
+int persist_write_int(const uint32_t key, const int32_t value) {
+    int free_slot = -1;
+    for (int i = 0; i < PERSIST_SLOTS; i++) {
+        if (persist_store[i].used && persist_store[i].key == key) {
+            persist_store[i].value = value;
+            return sizeof(int32_t);
+        }
+        if (!persist_store[i].used && free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    persist_store[free_slot].key = key;
+    persist_store[free_slot].value = value;
+    persist_store[free_slot].used = true;
+    return sizeof(int32_t);
+}
+
+void vibes_enqueue_custom_pattern(VibePattern pattern) {
+    host_counters.vibe_patterns++;
+    for (uint32_t i = 0; i < pattern.num_segments; i += 2) {
+        host_counters.vibe_on_ms += pattern.durations[i];
+    }
+}
+
+void vibes_double_pulse(void) {
+    host_counters.vibe_double_pulses++;
+}
+
+void light_enable(bool enable) {
+}
+
+void app_event_loop(void) {
+}
+
+// ------------------------------------------------------------------ rendering
+
+void host_render(HostFrame *frame) {
+    Window *window = host_top_window();
+    memset(frame, 0, sizeof(HostFrame));
+    memset(drawn, 0, sizeof(drawn));
+    target = frame;
+
+    if (window) {
+        // the background clear is the compositor's, only what the layers draw is counted
+        memset(frame->pixels, window->background_color.argb, sizeof(frame->pixels));
+        render_layer(&window->root, GPoint(0, 0), GRect(0, 0, HOST_WIDTH, HOST_HEIGHT));
+    }
+
+#if defined(PBL_ROUND)
+    // the display is a circle, nothing outside it is visible
+    for (int y = 0; y < HOST_HEIGHT; y++) {
+        for (int x = 0; x < HOST_WIDTH; x++) {
+            int dx = 2 * x + 1 - HOST_WIDTH, dy = 2 * y + 1 - HOST_HEIGHT;
+            if (dx * dx + dy * dy > HOST_WIDTH * HOST_WIDTH) {
+                frame->pixels[y][x] = GColorBlack.argb;
+            }
+        }
+    }
+#endif
+
+    // count what the layers drew that differs from the previous frame,
+    // which is all a dirty-rect or cached redraw would have to draw
+    for (int y = 0; y < HOST_HEIGHT; y++) {
+        for (int x = 0; x < HOST_WIDTH; x++) {
+#if defined(PBL_BW)
+            frame->pixels[y][x] = reduce_to_bw(frame->pixels[y][x]);
+#endif
+            if (drawn[y][x] && frame->pixels[y][x] != previous[y][x]) {
+                frame->changed++;
+            }
+        }
+    }
+    memcpy(previous, frame->pixels, sizeof(previous));
+    target = NULL;
+}
+
+// ------------------------------------------------------------------ frame files
+
+// 1-bit frames are stored as black and white grayscale, color frames as RGB
+#if defined(PBL_BW)
+#define FRAME_PNG_FORMAT PNG_FORMAT_GRAY
+#define FRAME_PNG_CHANNELS 1
+#else
+#define FRAME_PNG_FORMAT PNG_FORMAT_RGB
+#define FRAME_PNG_CHANNELS 3
+#endif
+
+bool host_frame_write_png(const HostFrame *frame, const char *path) {
+    uint8_t data[HOST_HEIGHT * HOST_WIDTH * FRAME_PNG_CHANNELS];
+    for (int y = 0; y < HOST_HEIGHT; y++) {
+        for (int x = 0; x < HOST_WIDTH; x++) {
+            uint8_t argb = frame->pixels[y][x];
+            uint8_t *out = &data[(y * HOST_WIDTH + x) * FRAME_PNG_CHANNELS];
+#if defined(PBL_BW)
+            out[0] = argb == GColorWhite.argb ? 255 : 0;
+#else
+            out[0] = ((argb >> 4) & 3) * 85;
+            out[1] = ((argb >> 2) & 3) * 85;
+            out[2] = (argb & 3) * 85;
+#endif
+        }
+    }
+    png_image image;
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    image.width = HOST_WIDTH;
+    image.height = HOST_HEIGHT;
+    image.format = FRAME_PNG_FORMAT;
+    return png_image_write_to_file(&image, path, 0, data, 0, NULL) != 0;
+}
+
+bool host_frame_read_png(HostFrame *frame, const char *path) {
+    png_image image;
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_file(&image, path)) {
+        return false;
+    }
+    if (image.width != HOST_WIDTH || image.height != HOST_HEIGHT) {
+        png_image_free(&image);
+        return false;
+    }
+    image.format = FRAME_PNG_FORMAT;
+    uint8_t data[HOST_HEIGHT * HOST_WIDTH * FRAME_PNG_CHANNELS];
+    if (!png_image_finish_read(&image, NULL, data, 0, NULL)) {
+        return false;
+    }
+    for (int y = 0; y < HOST_HEIGHT; y++) {
+        for (int x = 0; x < HOST_WIDTH; x++) {
+            const uint8_t *in = &data[(y * HOST_WIDTH + x) * FRAME_PNG_CHANNELS];
+#if defined(PBL_BW)
+            frame->pixels[y][x] = in[0] >= 128 ? GColorWhite.argb : GColorBlack.argb;
+#else
+            frame->pixels[y][x] = 0xC0 | (in[0] >> 6) << 4 | (in[1] >> 6) << 2 | (in[2] >> 6);
+#endif
+        }
+    }
+    return true;
+}
+
+int host_frame_diff(const HostFrame *a, const HostFrame *b) {
+    int different = 0;
+    for (int y = 0; y < HOST_HEIGHT; y++) {
+        for (int x = 0; x < HOST_WIDTH; x++) {
+            different += a->pixels[y][x] != b->pixels[y][x];
+        }
+    }
+    return different;
+}
@@ -0,0 +1,87 @@
+/***
+    Copyright 2014 Carl Edwards
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing,
+    software distributed under the License is distributed on an
+    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+    KIND, either express or implied.  See the License for the
+    specific language governing permissions and limitations
+    under the License.
+*/
+
+#pragma once
+
+#include "pebble.h"
+
+/*
+    Test-side controls for the host stand-in: a simulated clock that
+    delivers ticks and fires app timers, button presses, call counters,
+    and a framebuffer the window stack is rendered into.
+*/
+
+#define HOST_WIDTH PBL_DISPLAY_WIDTH
+#define HOST_HEIGHT PBL_DISPLAY_HEIGHT
+
+#if defined(PBL_PLATFORM_APLITE)
+#define HOST_PLATFORM_NAME "aplite"
+#elif defined(PBL_PLATFORM_CHALK)
+#define HOST_PLATFORM_NAME "chalk"
+#elif defined(PBL_PLATFORM_EMERY)
+#define HOST_PLATFORM_NAME "emery"
+#elif defined(PBL_PLATFORM_GABBRO)
+#define HOST_PLATFORM_NAME "gabbro"
+#else
+#define HOST_PLATFORM_NAME "basalt"
+#endif
+
+typedef struct {
+    int strftime_calls;
+    int layer_set_frame_calls;
+    int text_layer_set_text_calls;
+    int layer_mark_dirty_calls;
+    int vibe_patterns;          // custom patterns
+    int vibe_on_ms;             // sum of the custom patterns' "on" segments
+    int vibe_double_pulses;     // firmware double pulses, their segments are not known
+} HostCounters;
+
+extern HostCounters host_counters;
+
+typedef struct {
+    uint8_t pixels[HOST_HEIGHT][HOST_WIDTH];    // GColor8 argb of every pixel
+    int writes;                                 // pixel writes by the layers, the background clear is not counted
+    int changed;                                // pixels the layers wrote that differ from the previous frame
+} HostFrame;
+
+// clock: set_time jumps without ticking, jump_to/advance deliver ticks and fire timers on the way
+void host_set_time(time_t seconds, uint16_t ms);
+void host_jump_to(time_t seconds);
+void host_advance_ms(int64_t ms);
+int64_t host_now_ms();
+
+void host_click(ButtonId button);
+void host_long_click(ButtonId button);
+
+void host_reset_counters();
+Window *host_top_window();
+
+// renders the top window the way the compositor would, reduced to black and white on
+// 1-bit displays, and counts the pixels drawn and the pixels that changed
+void host_render(HostFrame *frame);
+
+// frame files are PNGs, grayscale on 1-bit displays; load returns false if the file is missing or a different size
+bool host_frame_write_png(const HostFrame *frame, const char *path);
+bool host_frame_read_png(HostFrame *frame, const char *path);
+int host_frame_diff(const HostFrame *a, const HostFrame *b);
+
+int vitals_main(void);
+void app_init(void);
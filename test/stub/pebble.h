@@ -0,0 +1,271 @@
+/***
+    Copyright 2014 Carl Edwards
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing,
+    software distributed under the License is distributed on an
+    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+    KIND, either express or implied.  See the License for the
+    specific language governing permissions and limitations
+    under the License.
+*/
+
+/*
+    Host stand-in for the subset of the Pebble SDK the app uses, so the
+    sources in src/ build unchanged with the system compiler.  The
+    implementation lives in host.c; tests drive it through host.h.
+    The platform is picked with the same PBL_* defines the SDK sets.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(PBL_PLATFORM_EMERY)
+#define PBL_DISPLAY_WIDTH 200
+#define PBL_DISPLAY_HEIGHT 228
+#elif defined(PBL_PLATFORM_GABBRO)
+#define PBL_DISPLAY_WIDTH 260
+#define PBL_DISPLAY_HEIGHT 260
+#elif defined(PBL_ROUND)
+#define PBL_DISPLAY_WIDTH 180
+#define PBL_DISPLAY_HEIGHT 180
+#else
+#define PBL_DISPLAY_WIDTH 144
+#define PBL_DISPLAY_HEIGHT 168
+#endif
+
+// geometry
+
+typedef struct { int16_t x, y; } GPoint;
+typedef struct { int16_t w, h; } GSize;
+typedef struct { GPoint origin; GSize size; } GRect;
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GSize(w, h) ((GSize){(w), (h)})
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+GPoint grect_center_point(const GRect *rect);
+
+// colors, stored like the SDK's GColor8: 2 bits each of alpha, red, green, blue
+
+typedef union { uint8_t argb; } GColor8;
+typedef GColor8 GColor;
+#define GColorClear ((GColor8){.argb = 0x00})
+#define GColorBlack ((GColor8){.argb = 0xC0})
+#define GColorWhite ((GColor8){.argb = 0xFF})
+
+typedef enum { GTextAlignmentLeft, GTextAlignmentCenter, GTextAlignmentRight } GTextAlignment;
+typedef enum {
+    GAlignCenter, GAlignTopLeft, GAlignTopRight, GAlignTop,
+    GAlignLeft, GAlignBottom, GAlignRight, GAlignBottomRight, GAlignBottomLeft
+} GAlign;
+
+// math
+
+#define TRIG_MAX_ANGLE 0x10000
+#define TRIG_MAX_RATIO 0xffff
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+#define ARRAY_LENGTH(array) (sizeof(array) / sizeof((array)[0]))
+
+// logging
+
+#define APP_LOG_LEVEL_ERROR 1
+#define APP_LOG_LEVEL_WARNING 50
+#define APP_LOG_LEVEL_INFO 100
+#define APP_LOG_LEVEL_DEBUG 200
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...);
+#define APP_LOG(level, fmt, ...) app_log(level, __FILE__, __LINE__, fmt, ## __VA_ARGS__)
+
+// graphics
+
+typedef struct GContext GContext;
+typedef struct GBitmap GBitmap;
+typedef const struct HostFont *GFont;
+
+typedef struct {
+    uint32_t num_points;
+    GPoint *points;
+} GPathInfo;
+
+typedef struct {
+    uint32_t num_points;
+    GPoint *points;
+    int32_t rotation;
+    GPoint offset;
+} GPath;
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+void graphics_draw_pixel(GContext *ctx, GPoint point);
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1);
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, int corner_mask);
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius);
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius);
+
+GPath *gpath_create(const GPathInfo *init);
+void gpath_destroy(GPath *path);
+void gpath_rotate_to(GPath *path, int32_t angle);
+void gpath_move_to(GPath *path, GPoint point);
+void gpath_draw_filled(GContext *ctx, GPath *path);
+void gpath_draw_outline(GContext *ctx, GPath *path);
+
+#define FONT_KEY_GOTHIC_14 "RESOURCE_ID_GOTHIC_14"
+#define FONT_KEY_GOTHIC_14_BOLD "RESOURCE_ID_GOTHIC_14_BOLD"
+#define FONT_KEY_GOTHIC_18 "RESOURCE_ID_GOTHIC_18"
+#define FONT_KEY_GOTHIC_18_BOLD "RESOURCE_ID_GOTHIC_18_BOLD"
+#define FONT_KEY_GOTHIC_24 "RESOURCE_ID_GOTHIC_24"
+#define FONT_KEY_GOTHIC_24_BOLD "RESOURCE_ID_GOTHIC_24_BOLD"
+GFont fonts_get_system_font(const char *font_key);
+
+// resources, ids follow the media order in appinfo.json
+
+#define RESOURCE_ID_IMAGE_MENU_ICON 1
+#define RESOURCE_ID_WATCHFACE_BACKGROUND 2
+#define RESOURCE_ID_HEART 3
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id);
+void gbitmap_destroy(GBitmap *bitmap);
+
+// layers
+
+typedef struct Layer Layer;
+typedef struct TextLayer TextLayer;
+typedef struct BitmapLayer BitmapLayer;
+typedef struct MenuLayer MenuLayer;
+typedef struct SimpleMenuLayer SimpleMenuLayer;
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+
+Layer *layer_create(GRect frame);
+void layer_destroy(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_mark_dirty(Layer *layer);
+void layer_set_frame(Layer *layer, GRect frame);
+GRect layer_get_frame(const Layer *layer);
+GRect layer_get_bounds(const Layer *layer);
+void layer_set_hidden(Layer *layer, bool hidden);
+void layer_add_child(Layer *parent, Layer *child);
+
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+
+BitmapLayer *bitmap_layer_create(GRect frame);
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer);
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer);
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap);
+void bitmap_layer_set_alignment(BitmapLayer *bitmap_layer, GAlign alignment);
+
+// windows and clicks
+
+typedef struct Window Window;
+typedef void *ClickRecognizerRef;
+typedef void (*ClickHandler)(ClickRecognizerRef recognizer, void *context);
+typedef void (*ClickConfigProvider)(void *context);
+typedef void (*WindowHandler)(Window *window);
+typedef struct {
+    WindowHandler load;
+    WindowHandler appear;
+    WindowHandler disappear;
+    WindowHandler unload;
+} WindowHandlers;
+typedef enum { BUTTON_ID_BACK = 0, BUTTON_ID_UP, BUTTON_ID_SELECT, BUTTON_ID_DOWN, NUM_BUTTONS } ButtonId;
+
+Window *window_create(void);
+void window_destroy(Window *window);
+Layer *window_get_root_layer(const Window *window);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+void window_set_background_color(Window *window, GColor background_color);
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider);
+void window_set_click_config_provider_with_context(Window *window, ClickConfigProvider click_config_provider, void *context);
+ClickConfigProvider window_get_click_config_provider(const Window *window);
+void *window_get_click_config_context(Window *window);
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler);
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler, ClickHandler up_handler);
+void window_stack_push(Window *window, bool animated);
+Window *window_stack_pop(bool animated);
+void window_stack_pop_all(const bool animated);
+bool window_stack_contains_window(Window *window);
+
+// menus
+
+typedef void (*SimpleMenuLayerSelectCallback)(int index, void *context);
+typedef struct {
+    const char *title;
+    const char *subtitle;
+    GBitmap *icon;
+    SimpleMenuLayerSelectCallback callback;
+} SimpleMenuItem;
+typedef struct {
+    const char *title;
+    const SimpleMenuItem *items;
+    uint32_t num_items;
+} SimpleMenuSection;
+
+SimpleMenuLayer *simple_menu_layer_create(GRect frame, Window *window, const SimpleMenuSection *sections, int32_t num_sections, void *callback_context);
+void simple_menu_layer_destroy(SimpleMenuLayer *menu_layer);
+Layer *simple_menu_layer_get_layer(const SimpleMenuLayer *simple_menu);
+void menu_layer_reload_data(MenuLayer *menu_layer);
+
+// services
+
+typedef enum {
+    SECOND_UNIT = 1 << 0,
+    MINUTE_UNIT = 1 << 1,
+    HOUR_UNIT = 1 << 2,
+    DAY_UNIT = 1 << 3,
+    MONTH_UNIT = 1 << 4,
+    YEAR_UNIT = 1 << 5
+} TimeUnits;
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+void app_timer_cancel(AppTimer *timer_handle);
+
+typedef struct {
+    const uint32_t *durations;
+    uint32_t num_segments;
+} VibePattern;
+void vibes_double_pulse(void);
+void vibes_enqueue_custom_pattern(VibePattern pattern);
+void light_enable(bool enable);
+
+bool persist_exists(const uint32_t key);
+int32_t persist_read_int(const uint32_t key);
+bool persist_read_bool(const uint32_t key);
+int persist_write_int(const uint32_t key, const int32_t value);
+
+void app_event_loop(void);
+
+// the wall clock is the host's simulated clock, in UTC so results don't depend on the machine
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms);
+time_t host_time(time_t *tloc);
+struct tm *host_localtime(const time_t *timep);
+size_t host_strftime(char *s, size_t max, const char *format, const struct tm *tm);
+#ifndef HOST_IMPLEMENTATION
+#define time(tloc) host_time(tloc)
+#define localtime(timep) host_localtime(timep)
+#define strftime(s, max, format, tm) host_strftime(s, max, format, tm)
+#endif
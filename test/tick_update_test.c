@@ -0,0 +1,146 @@
+/***
+    Copyright 2014 Carl Edwards
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing,
+    software distributed under the License is distributed on an
+    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+    KIND, either express or implied.  See the License for the
+    specific language governing permissions and limitations
+    under the License.
+*/
+
+#include "host.h"
+#include "vitals.h"
+
+/*
+    Counts the date work done by the tick handler for each units_changed
+    mask: the date text is only formatted when the day changes, and the
+    date labels are only moved when a minute change moves the date.
+    Then moves the date to each location and checks the label frames
+    from this platform's layout table are on screen (inside the circle on
+    round displays) and on the side of the dial the location names.
+*/
+
+void handle_timer_tick(struct tm *tick_time, TimeUnits units_changed);
+
+// 2015-03-14 00:00:00 UTC, a Saturday
+#define TEST_DAY 1426291200
+
+static int failures;
+
+static void tick(int day, int hour, int minute, int second, TimeUnits units_changed) {
+    time_t seconds = TEST_DAY + day * 86400 + hour * 3600 + minute * 60 + second;
+    host_set_time(seconds, 0);
+    handle_timer_tick(localtime(&seconds), units_changed);
+}
+
+static void expect(const char *name, int strftime_calls, int layer_set_frame_calls, int text_layer_set_text_calls) {
+    bool ok = host_counters.strftime_calls == strftime_calls &&
+        host_counters.layer_set_frame_calls == layer_set_frame_calls &&
+        host_counters.text_layer_set_text_calls == text_layer_set_text_calls;
+    printf("%-8s %-4s %-34s strftime %3d  layer_set_frame %3d  text_layer_set_text %3d\n",
+        HOST_PLATFORM_NAME, ok ? "ok" : "FAIL", name, host_counters.strftime_calls,
+        host_counters.layer_set_frame_calls, host_counters.text_layer_set_text_calls);
+    if (ok == false) {
+        printf("         expected %d, %d, %d\n", strftime_calls, layer_set_frame_calls, text_layer_set_text_calls);
+        failures++;
+    }
+    host_reset_counters();
+}
+
+static bool on_screen(GRect frame) {
+    int corners[4][2] = {
+        { frame.origin.x, frame.origin.y },
+        { frame.origin.x + frame.size.w, frame.origin.y },
+        { frame.origin.x, frame.origin.y + frame.size.h },
+        { frame.origin.x + frame.size.w, frame.origin.y + frame.size.h },
+    };
+    for (int i = 0; i < 4; i++) {
+        int x = corners[i][0], y = corners[i][1];
+        if (x < 0 || y < 0 || x > HOST_WIDTH || y > HOST_HEIGHT) {
+            return false;
+        }
+#if defined(PBL_ROUND)
+        int dx = 2 * x - HOST_WIDTH, dy = 2 * y - HOST_HEIGHT;
+        if (dx * dx + dy * dy > HOST_WIDTH * HOST_WIDTH) {
+            return false;
+        }
+#endif
+    }
+    return true;
+}
+
+// whether the frame is entirely on the given side of the dial's center
+static bool on_side(GRect frame, DateLocation location) {
+    switch (location) {
+    case Top:
+        return frame.origin.y + frame.size.h <= HOST_HEIGHT / 2;
+    case Bottom:
+        return frame.origin.y >= HOST_HEIGHT / 2;
+    case Left:
+        return frame.origin.x + frame.size.w <= HOST_WIDTH / 2;
+    case Right:
+        return frame.origin.x >= HOST_WIDTH / 2;
+    }
+    return false;
+}
+
+static void expect_location(int hour, int minute, DateLocation location, const char *name) {
+    tick(3, hour, minute, 0, SECOND_UNIT | MINUTE_UNIT);
+    GRect day = layer_get_frame(text_layer_get_layer(app.day_label));
+    GRect num = layer_get_frame(text_layer_get_layer(app.num_label));
+    bool ok = app.date_location == location && on_screen(day) && on_screen(num) &&
+        on_side(day, location) && on_side(num, location);
+    printf("%-8s %-4s date at %-27s day %3d,%3d %dx%d  num %3d,%3d %dx%d\n",
+        HOST_PLATFORM_NAME, ok ? "ok" : "FAIL", name,
+        day.origin.x, day.origin.y, day.size.w, day.size.h, num.origin.x, num.origin.y, num.size.w, num.size.h);
+    if (ok == false) {
+        failures++;
+    }
+    host_reset_counters();
+}
+
+int main(void) {
+    // 10:09, the date starts at the Bottom
+    host_set_time(TEST_DAY + 10 * 3600 + 9 * 60, 0);
+    app_init();
+    host_reset_counters();
+
+    for (int second = 1; second < 60; second++) {
+        tick(0, 10, 9, second, SECOND_UNIT);
+    }
+    expect("59 SECOND-only ticks", 0, 0, 0);
+
+    tick(0, 10, 10, 0, SECOND_UNIT | MINUTE_UNIT);
+    expect("MINUTE tick, date stays put", 0, 0, 0);
+
+    tick(0, 10, 16, 0, SECOND_UNIT | MINUTE_UNIT);
+    expect("MINUTE tick, date moves to Top", 0, 2, 0);
+
+    tick(1, 0, 0, 0, SECOND_UNIT | MINUTE_UNIT | HOUR_UNIT | DAY_UNIT);
+    expect("DAY tick, date moves to Bottom", 2, 2, 2);
+
+    tick(2, 0, 0, 0, SECOND_UNIT | MINUTE_UNIT | HOUR_UNIT | DAY_UNIT);
+    expect("DAY tick, date stays put", 2, 0, 2);
+
+    expect_location(4, 35, Top, "Top");
+    expect_location(8, 50, Right, "Right");
+    expect_location(10, 10, Bottom, "Bottom");
+    expect_location(1, 20, Left, "Left");
+
+    if (failures) {
+        printf("%s: %d failures\n", HOST_PLATFORM_NAME, failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+/***
+    Copyright 2014 Carl Edwards
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing,
+    software distributed under the License is distributed on an
+    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+    KIND, either express or implied.  See the License for the
+    specific language governing permissions and limitations
+    under the License.
+*/
+
+#include "host.h"
+#include "vitals.h"
+#include "timing.h"
+
+/*
+    Runs whole counts on the simulated clock and checks the tick series.
+    Ticks arrive on the second boundary, so a count started 300ms into a
+    second has the second hand 300ms ahead of the real count on every tick
+    while tick delivery itself is on time.
+*/
+
+// 2015-03-14 09:00:00 UTC
+#define COUNT_START 1426323600
+
+static int failures;
+
+static void expect_histogram(const char *name, TimingSeries series, int samples, int min_ms, int max_ms, int first_bucket, int last_bucket) {
+    const TimingHistogram *h = timing_histogram(series);
+    bool ok = h->samples == samples && h->min_ms == min_ms && h->max_ms == max_ms &&
+        h->buckets[0] == first_bucket && h->buckets[TIMING_BUCKET_COUNT - 1] == last_bucket;
+    printf("%-8s %-4s %-28s n=%3d  %4d..%4d ms  buckets %d/%d/%d/%d/%d/%d\n",
+        HOST_PLATFORM_NAME, ok ? "ok" : "FAIL", name, h->samples, h->min_ms, h->max_ms,
+        h->buckets[0], h->buckets[1], h->buckets[2], h->buckets[3], h->buckets[4], h->buckets[5]);
+    if (ok == false) {
+        printf("         expected n=%d %d..%d, first bucket %d, last bucket %d\n",
+            samples, min_ms, max_ms, first_bucket, last_bucket);
+        failures++;
+    }
+}
+
+static void run_count(time_t start, uint16_t ms) {
+    host_set_time(start, ms);
+    host_click(BUTTON_ID_SELECT);
+    host_advance_ms((app.settings.delay + app.settings.timeout) * 1000 + 1000);
+}
+
+int main(void) {
+    host_set_time(COUNT_START, 0);
+    app_init();
+
+    // 5s delay and 30s count: a tick for each of the 35 seconds
+    run_count(COUNT_START + 60, 300);
+    expect_histogram("Tick, count at .300", TimingSeriesTickLag, 35, 0, 0, 35, 0);
+    expect_histogram("Hand, count at .300", TimingSeriesHandDrift, 35, 300, 300, 0, 35);
+
+    run_count(COUNT_START + 120, 0);
+    expect_histogram("Tick, then a count at .000", TimingSeriesTickLag, 70, 0, 0, 70, 0);
+    expect_histogram("Hand, then a count at .000", TimingSeriesHandDrift, 70, 0, 300, 35, 35);
+
+    if (failures) {
+        printf("%s: %d failures\n", HOST_PLATFORM_NAME, failures);
+        return 1;
+    }
+    return 0;
+}